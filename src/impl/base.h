@@ -12,22 +12,34 @@
 
 #include <stdexcept>
 #include <assert.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <future>
 #include <list>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <mutex>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 #include <set>
 #include <filesystem>
+#include <thread>
 #include <utility>
 
+#include "simd.h"
+
 #if defined(_DEBUG)
 #define XLANG_DEBUG
 #define XLANG_ASSERT assert
@@ -66,7 +78,216 @@ namespace winmd
 
         inline bool starts_with(std::string_view const& value, std::string_view const& match) noexcept
         {
-            return 0 == value.compare(0, match.size(), match);
+            return value.size() >= match.size() && equal_bytes(value.data(), match.data(), match.size());
+        }
+
+        // 64-bit FNV-1a. Pass a previous result as the seed to hash several strings as one key.
+        constexpr uint64_t hash_string(std::string_view const& value, uint64_t hash = 0xcbf29ce484222325) noexcept
+        {
+            for (auto c : value)
+            {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 0x100000001b3;
+            }
+
+            return hash;
+        }
+
+        // Calls callback(index) for every index in [0, count) on up to concurrency worker threads (0 picks the
+        // hardware concurrency). Workers claim indices in order, so callers can merge results deterministically.
+        // The first exception thrown by a callback is rethrown once all workers have finished.
+        template <typename F>
+        void parallel_for(std::size_t const count, uint32_t concurrency, F const& callback)
+        {
+            if (concurrency == 0)
+            {
+                concurrency = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            auto const workers = static_cast<uint32_t>(std::min<std::size_t>(concurrency, count));
+
+            if (workers <= 1)
+            {
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    callback(index);
+                }
+
+                return;
+            }
+
+            std::atomic<std::size_t> next{ 0 };
+            std::vector<std::future<void>> futures;
+            futures.reserve(workers);
+
+            for (uint32_t worker = 0; worker < workers; ++worker)
+            {
+                futures.push_back(std::async(std::launch::async, [&]
+                {
+                    for (auto index = next++; index < count; index = next++)
+                    {
+                        callback(index);
+                    }
+                }));
+            }
+
+            std::exception_ptr error;
+
+            for (auto&& future : futures)
+            {
+                try
+                {
+                    future.get();
+                }
+                catch (...)
+                {
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // Calls callback(index) for every index of weights on up to concurrency worker threads (0 picks the hardware
+        // concurrency), balancing the workers by total weight. Indices are dealt out heaviest first into one queue
+        // per worker. Each worker takes from the front of its own queue and, once that is empty, steals from the
+        // back of the queue with the most weight left. The first exception thrown by a callback is rethrown once
+        // all workers have finished.
+        template <typename F>
+        void parallel_for_weighted(std::vector<std::size_t> const& weights, uint32_t concurrency, F const& callback)
+        {
+            if (concurrency == 0)
+            {
+                concurrency = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            auto const workers = static_cast<uint32_t>(std::min<std::size_t>(concurrency, weights.size()));
+            std::vector<std::size_t> order(weights.size());
+
+            for (std::size_t index = 0; index < order.size(); ++index)
+            {
+                order[index] = index;
+            }
+
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t const lhs, std::size_t const rhs)
+            {
+                return weights[lhs] > weights[rhs];
+            });
+
+            if (workers <= 1)
+            {
+                for (auto&& index : order)
+                {
+                    callback(index);
+                }
+
+                return;
+            }
+
+            struct queue
+            {
+                std::mutex mutex;
+                std::deque<std::size_t> indices;
+                std::size_t weight{};
+            };
+
+            std::vector<queue> queues(workers);
+
+            for (std::size_t position = 0; position < order.size(); ++position)
+            {
+                auto& queue = queues[position % workers];
+                queue.indices.push_back(order[position]);
+                queue.weight += weights[order[position]];
+            }
+
+            auto take = [&](queue& queue, bool const front, std::size_t& index)
+            {
+                std::lock_guard const lock{ queue.mutex };
+
+                if (queue.indices.empty())
+                {
+                    return false;
+                }
+
+                index = front ? queue.indices.front() : queue.indices.back();
+                front ? queue.indices.pop_front() : queue.indices.pop_back();
+                queue.weight -= weights[index];
+                return true;
+            };
+
+            auto steal = [&](std::size_t& index)
+            {
+                while (true)
+                {
+                    queue* victim{};
+                    std::size_t most{};
+
+                    for (auto&& queue : queues)
+                    {
+                        std::lock_guard const lock{ queue.mutex };
+
+                        if (!queue.indices.empty() && (!victim || queue.weight > most))
+                        {
+                            victim = &queue;
+                            most = queue.weight;
+                        }
+                    }
+
+                    if (!victim)
+                    {
+                        return false;
+                    }
+
+                    if (take(*victim, false, index))
+                    {
+                        return true;
+                    }
+                }
+            };
+
+            std::vector<std::future<void>> futures;
+            futures.reserve(workers);
+
+            for (uint32_t worker = 0; worker < workers; ++worker)
+            {
+                futures.push_back(std::async(std::launch::async, [&, worker]
+                {
+                    std::size_t index{};
+
+                    while (take(queues[worker], true, index) || steal(index))
+                    {
+                        callback(index);
+                    }
+                }));
+            }
+
+            std::exception_ptr error;
+
+            for (auto&& future : futures)
+            {
+                try
+                {
+                    future.get();
+                }
+                catch (...)
+                {
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
         }
     }
 }
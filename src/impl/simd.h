@@ -0,0 +1,388 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define WINMD_SIMD_X64
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define WINMD_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// Functions using AVX2 are compiled for it individually and only called once the processor is known to support it.
+#if defined(WINMD_SIMD_X64) && (defined(__GNUC__) || defined(__clang__))
+#define WINMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WINMD_TARGET_AVX2
+#endif
+
+namespace winmd::impl
+{
+    // SSE2 is part of x64 and NEON of ARM64, so only AVX2 needs to be detected at run time.
+    enum class simd_level
+    {
+        scalar,
+        sse2,
+        avx2,
+        neon,
+    };
+
+    inline simd_level detect_simd_level() noexcept
+    {
+#if defined(WINMD_SIMD_X64)
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4]{};
+        __cpuid(info, 0);
+
+        if (info[0] >= 7)
+        {
+            __cpuid(info, 1);
+            bool const os_saves_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+            __cpuidex(info, 7, 0);
+
+            if (os_saves_avx && (info[1] & (1 << 5)))
+            {
+                return simd_level::avx2;
+            }
+        }
+
+        return simd_level::sse2;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? simd_level::avx2 : simd_level::sse2;
+#endif
+#elif defined(WINMD_SIMD_NEON)
+        return simd_level::neon;
+#else
+        return simd_level::scalar;
+#endif
+    }
+
+    inline simd_level supported_simd_level() noexcept
+    {
+        static simd_level const level = detect_simd_level();
+        return level;
+    }
+
+    inline uint32_t count_trailing_zeros(uint64_t const value) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index{};
+#if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanForward64(&index, value);
+        return index;
+#else
+        if (_BitScanForward(&index, static_cast<unsigned long>(value)))
+        {
+            return index;
+        }
+
+        _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+        return index + 32;
+#endif
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    template <typename T>
+    T load_unaligned(void const* address) noexcept
+    {
+        T value;
+        std::memcpy(&value, address, sizeof(T));
+        return value;
+    }
+
+    namespace simd
+    {
+        // Each kernel appends the offset from origin of every zero byte in [position, last), in order, and hands
+        // the tail that does not fill a vector to a narrower kernel.
+
+        inline void append_bits(uint64_t mask, uint32_t const base, std::vector<uint32_t>& offsets)
+        {
+            while (mask)
+            {
+                offsets.push_back(base + count_trailing_zeros(mask));
+                mask &= mask - 1;
+            }
+        }
+
+        // Eight bytes at a time: a word holds a zero byte exactly when (word - 0x01..01) & ~word & 0x80..80 is set.
+        inline void find_zero_bytes_scalar(uint8_t const* const origin, uint8_t const* position, uint8_t const* const last, std::vector<uint32_t>& offsets)
+        {
+            for (; last - position >= 8; position += 8)
+            {
+                auto const word = load_unaligned<uint64_t>(position);
+
+                if ((word - 0x0101010101010101) & ~word & 0x8080808080808080)
+                {
+                    for (uint32_t byte = 0; byte < 8; ++byte)
+                    {
+                        if (!position[byte])
+                        {
+                            offsets.push_back(static_cast<uint32_t>(position - origin) + byte);
+                        }
+                    }
+                }
+            }
+
+            for (; position != last; ++position)
+            {
+                if (!*position)
+                {
+                    offsets.push_back(static_cast<uint32_t>(position - origin));
+                }
+            }
+        }
+
+#if defined(WINMD_SIMD_X64)
+        inline void find_zero_bytes_sse2(uint8_t const* const origin, uint8_t const* position, uint8_t const* const last, std::vector<uint32_t>& offsets)
+        {
+            auto const zero = _mm_setzero_si128();
+
+            for (; last - position >= 16; position += 16)
+            {
+                auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(position));
+                auto const mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)));
+                append_bits(mask, static_cast<uint32_t>(position - origin), offsets);
+            }
+
+            find_zero_bytes_scalar(origin, position, last, offsets);
+        }
+
+        WINMD_TARGET_AVX2 inline void find_zero_bytes_avx2(uint8_t const* const origin, uint8_t const* position, uint8_t const* const last, std::vector<uint32_t>& offsets)
+        {
+            auto const zero = _mm256_setzero_si256();
+
+            for (; last - position >= 64; position += 64)
+            {
+                auto const low = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(position));
+                auto const high = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(position + 32));
+                auto const low_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, zero)));
+                auto const high_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, zero)));
+                append_bits(low_mask | (uint64_t{ high_mask } << 32), static_cast<uint32_t>(position - origin), offsets);
+            }
+
+            find_zero_bytes_sse2(origin, position, last, offsets);
+        }
+#endif
+
+#if defined(WINMD_SIMD_NEON)
+        // NEON has no movemask. Narrowing the comparison leaves four bits per byte, of which one is kept.
+        inline void find_zero_bytes_neon(uint8_t const* const origin, uint8_t const* position, uint8_t const* const last, std::vector<uint32_t>& offsets)
+        {
+            for (; last - position >= 16; position += 16)
+            {
+                auto const equal = vceqzq_u8(vld1q_u8(position));
+                auto const nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+                auto mask = nibbles & 0x8888888888888888;
+
+                while (mask)
+                {
+                    offsets.push_back(static_cast<uint32_t>(position - origin) + count_trailing_zeros(mask) / 4);
+                    mask &= mask - 1;
+                }
+            }
+
+            find_zero_bytes_scalar(origin, position, last, offsets);
+        }
+#endif
+
+        // Each kernel returns the first zero byte in [position, last), or nullptr if there is none.
+
+        inline uint8_t const* find_terminator_scalar(uint8_t const* position, uint8_t const* const last) noexcept
+        {
+            for (; last - position >= 8; position += 8)
+            {
+                auto const word = load_unaligned<uint64_t>(position);
+
+                if ((word - 0x0101010101010101) & ~word & 0x8080808080808080)
+                {
+                    break;
+                }
+            }
+
+            for (; position != last; ++position)
+            {
+                if (!*position)
+                {
+                    return position;
+                }
+            }
+
+            return nullptr;
+        }
+
+#if defined(WINMD_SIMD_X64)
+        inline uint8_t const* find_terminator_sse2(uint8_t const* position, uint8_t const* const last) noexcept
+        {
+            auto const zero = _mm_setzero_si128();
+
+            for (; last - position >= 16; position += 16)
+            {
+                auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(position));
+
+                if (auto const mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero))))
+                {
+                    return position + count_trailing_zeros(mask);
+                }
+            }
+
+            return find_terminator_scalar(position, last);
+        }
+
+        WINMD_TARGET_AVX2 inline uint8_t const* find_terminator_avx2(uint8_t const* position, uint8_t const* const last) noexcept
+        {
+            auto const zero = _mm256_setzero_si256();
+
+            for (; last - position >= 32; position += 32)
+            {
+                auto const bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(position));
+
+                if (auto const mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, zero))))
+                {
+                    return position + count_trailing_zeros(mask);
+                }
+            }
+
+            return find_terminator_sse2(position, last);
+        }
+#endif
+
+#if defined(WINMD_SIMD_NEON)
+        inline uint8_t const* find_terminator_neon(uint8_t const* position, uint8_t const* const last) noexcept
+        {
+            for (; last - position >= 16; position += 16)
+            {
+                auto const equal = vceqzq_u8(vld1q_u8(position));
+                auto const nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+
+                if (nibbles)
+                {
+                    return position + count_trailing_zeros(nibbles) / 4;
+                }
+            }
+
+            return find_terminator_scalar(position, last);
+        }
+#endif
+    }
+
+    // Appends the offset from first of every zero byte in [first, last), such as the terminators of a string heap.
+    // The level defaults to the widest the processor supports; any other level must also be supported.
+    inline void find_zero_bytes(uint8_t const* const first, uint8_t const* const last, std::vector<uint32_t>& offsets, simd_level const level = supported_simd_level())
+    {
+        switch (level)
+        {
+#if defined(WINMD_SIMD_X64)
+        case simd_level::avx2:
+            return simd::find_zero_bytes_avx2(first, first, last, offsets);
+        case simd_level::sse2:
+            return simd::find_zero_bytes_sse2(first, first, last, offsets);
+#endif
+#if defined(WINMD_SIMD_NEON)
+        case simd_level::neon:
+            return simd::find_zero_bytes_neon(first, first, last, offsets);
+#endif
+        default:
+            return simd::find_zero_bytes_scalar(first, first, last, offsets);
+        }
+    }
+
+    // The first zero byte in [first, last), or nullptr if there is none, such as the terminator of a string in
+    // a heap. The level is chosen as for find_zero_bytes.
+    inline uint8_t const* find_terminator(uint8_t const* const first, uint8_t const* const last, simd_level const level = supported_simd_level()) noexcept
+    {
+        switch (level)
+        {
+#if defined(WINMD_SIMD_X64)
+        case simd_level::avx2:
+            return simd::find_terminator_avx2(first, last);
+        case simd_level::sse2:
+            return simd::find_terminator_sse2(first, last);
+#endif
+#if defined(WINMD_SIMD_NEON)
+        case simd_level::neon:
+            return simd::find_terminator_neon(first, last);
+#endif
+        default:
+            return simd::find_terminator_scalar(first, last);
+        }
+    }
+
+    // Whether the size bytes at lhs and rhs are equal. Short names are compared with a pair of overlapping word
+    // loads and longer ones a vector at a time, inline rather than through a call to memcmp. The vector width is
+    // fixed at compile time to SSE2 or NEON, which every x64 or ARM64 processor has; names rarely exceed one
+    // vector, so a run-time switch to AVX2 would cost more than it saves. The path depends on
+    // size, so this beats memcmp where one side is fixed, such as a filter rule or a literal name, and loses to it
+    // where sizes vary unpredictably from call to call.
+    inline bool equal_bytes(char const* const lhs, char const* const rhs, std::size_t const size) noexcept
+    {
+        if (size > 16)
+        {
+#if defined(WINMD_SIMD_X64)
+            auto equal16 = [](char const* const lhs, char const* const rhs) noexcept
+            {
+                auto const left = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs));
+                auto const right = _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs));
+                return _mm_movemask_epi8(_mm_cmpeq_epi8(left, right)) == 0xffff;
+            };
+#elif defined(WINMD_SIMD_NEON)
+            auto equal16 = [](char const* const lhs, char const* const rhs) noexcept
+            {
+                auto const left = vld1q_u8(reinterpret_cast<uint8_t const*>(lhs));
+                auto const right = vld1q_u8(reinterpret_cast<uint8_t const*>(rhs));
+                return vminvq_u8(vceqq_u8(left, right)) == 0xff;
+            };
+#else
+            auto equal16 = [](char const* const lhs, char const* const rhs) noexcept
+            {
+                return ((load_unaligned<uint64_t>(lhs) ^ load_unaligned<uint64_t>(rhs)) |
+                    (load_unaligned<uint64_t>(lhs + 8) ^ load_unaligned<uint64_t>(rhs + 8))) == 0;
+            };
+#endif
+            for (std::size_t offset = 16; offset + 16 < size; offset += 16)
+            {
+                if (!equal16(lhs + offset, rhs + offset))
+                {
+                    return false;
+                }
+            }
+
+            return equal16(lhs, rhs) & equal16(lhs + size - 16, rhs + size - 16);
+        }
+
+        // Two loads that overlap in the middle cover every size from one word to two.
+        if (size >= 8)
+        {
+            return ((load_unaligned<uint64_t>(lhs) ^ load_unaligned<uint64_t>(rhs)) |
+                (load_unaligned<uint64_t>(lhs + size - 8) ^ load_unaligned<uint64_t>(rhs + size - 8))) == 0;
+        }
+
+        if (size >= 4)
+        {
+            return ((load_unaligned<uint32_t>(lhs) ^ load_unaligned<uint32_t>(rhs)) |
+                (load_unaligned<uint32_t>(lhs + size - 4) ^ load_unaligned<uint32_t>(rhs + size - 4))) == 0;
+        }
+
+        if (size)
+        {
+            return ((lhs[0] ^ rhs[0]) | (lhs[size / 2] ^ rhs[size / 2]) | (lhs[size - 1] ^ rhs[size - 1])) == 0;
+        }
+
+        return true;
+    }
+
+    inline bool equal(std::string_view const& lhs, std::string_view const& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && equal_bytes(lhs.data(), rhs.data(), lhs.size());
+    }
+}
@@ -1,63 +1,185 @@
 
 namespace winmd::reader
 {
+    // Applies a cache's type filter to the rows of one database. filter specializes this to decide whole
+    // namespaces at a time.
+    template <typename TypeFilter>
+    struct database_type_filter
+    {
+        explicit database_type_filter(TypeFilter& filter) noexcept : m_filter{ filter }
+        {
+        }
+
+        bool operator()(TypeDef const& type)
+        {
+            return m_filter(type);
+        }
+
+    private:
+
+        TypeFilter& m_filter;
+    };
+
     struct cache
     {
         cache() = default;
         cache(cache const&) = delete;
         cache& operator=(cache const&) = delete;
 
+        // Selects lazy classification: each namespace is sorted into its interfaces, classes, enums, structs,
+        // delegates, attributes and contracts lists on the first use of any of those lists, rather than while the
+        // cache is built. find() and namespace_members::types are complete from the start.
+        struct lazy_classification
+        {
+        };
+
+        template<typename C, typename T = typename C::value_type, typename TypeFilter>
+        explicit cache(C const& files, TypeFilter filter, lazy_classification)
+        {
+            for (auto&& file : files)
+            {
+                add_types(m_databases.emplace_back(file, this), filter);
+            }
+
+            build_index();
+        }
+
+        template<typename C, typename T = typename C::value_type>
+        explicit cache(C const& files, lazy_classification) : cache{ files, default_type_filter{}, lazy_classification{} }
+        {
+        }
+
+        template<typename C, typename T = typename C::value_type, typename TypeFilter>
+        explicit cache(C const& files, TypeFilter filter) : cache{ files, filter, lazy_classification{} }
+        {
+            classify_types();
+        }
+
+        struct parallel_load
+        {
+            // Maximum number of worker threads; zero uses std::thread::hardware_concurrency.
+            uint32_t concurrency{};
+
+            // Validating each file on its worker lets the merged cache read without bounds checks.
+            open_mode mode{ open_mode::checked };
+        };
+
+        // Opens and indexes each file on a pool of worker threads, then merges the per-file results in the order
+        // of files, so the resulting cache is identical to the one built by the serial constructor. The filter is
+        // called concurrently from the worker threads and must therefore be safe to call from multiple threads.
         template<typename C, typename T = typename C::value_type, typename TypeFilter>
-        explicit cache(C const& files, TypeFilter filter)
+        explicit cache(C const& files, TypeFilter filter, parallel_load const& options)
         {
+            std::vector<T const*> paths;
+
             for (auto&& file : files)
             {
-                auto& db = m_databases.emplace_back(file, this);
+                paths.push_back(&file);
+            }
+
+            std::vector<file_index> indexes(paths.size());
+
+            impl::parallel_for(paths.size(), options.concurrency, [&](std::size_t const index)
+            {
+                auto& result = indexes[index];
+                auto& db = result.databases.emplace_back(*paths[index], this, options.mode);
+                database_type_filter<TypeFilter> includes{ filter };
 
                 for (auto&& type : db.TypeDef)
                 {
-                    if (type.Flags().value == 0 || is_nested(type) || !filter(type))
+                    if (type.Flags().value == 0 || is_nested(type) || !includes(type))
                     {
                         continue;
                     }
 
-                    auto& ns = m_namespaces[type.TypeNamespace()];
-                    std::string_view name = type.TypeName();
-                    auto fpos = name.rfind('@');
-                    if (fpos != std::string_view::npos)
-                    {
-                        auto same_name = name.substr(0, fpos);
-                        auto it = ns.types_same_name.find(same_name);
-                        if (it == ns.types_same_name.end())
-                        {
-                            ns.types_same_name.try_emplace(same_name, std::vector<TypeDef>{ type });
-                        }
-                        else
-                        {
-							std::vector<TypeDef>& vec= it->second;
-                            vec.push_back(type);
-							for (size_t i = 0; i < vec.size() - 1; i++)
-							{
-								vec[i].next = &vec[i + 1];
-							}
-                        }
-                    }
-                    ns.types.try_emplace(name, type);
+                    result.namespaces[type.TypeNamespace()].push_back(type);
                 }
 
                 for (auto&& row : db.NestedClass)
                 {
-                    m_nested_types[row.EnclosingType()].push_back(row.NestedType());
+                    result.nested_types.emplace_back(row.EnclosingType(), row.NestedType());
                 }
-            }
+            });
 
-            for (auto&&[namespace_name, members] : m_namespaces)
+            for (auto&& index : indexes)
             {
-                for (auto&&[name, type] : members.types)
+                m_databases.splice(m_databases.end(), index.databases);
+
+                for (auto&&[namespace_name, types] : index.namespaces)
+                {
+                    auto& ns = m_namespaces[namespace_name];
+
+                    for (auto&& type : types)
+                    {
+                        add_type(ns, type);
+                    }
+                }
+
+                for (auto&&[enclosing_type, nested_type] : index.nested_types)
                 {
-                    add_type_to_members(type, members);
+                    add_nested_type(enclosing_type, nested_type);
                 }
             }
+
+            std::vector<namespace_members*> members;
+            members.reserve(m_namespaces.size());
+
+            for (auto&&[namespace_name, ns] : m_namespaces)
+            {
+                members.push_back(&ns);
+            }
+
+            impl::parallel_for(members.size(), options.concurrency, [&](std::size_t const index)
+            {
+                members[index]->classify();
+            });
+
+            build_index();
+        }
+
+        struct snapshot
+        {
+            // The sidecar file, typically next to the output of the tool that loads the cache.
+            std::string path;
+        };
+
+        // Loads the indexes from the snapshot at options.path if it was written for exactly these files and none of
+        // them has changed since, as judged by size, modification time and database::fingerprint. Otherwise builds
+        // the cache as the serial constructor does and rewrites the snapshot. A cache loaded from a snapshot answers
+        // find and find_nested from the mapped file, and only builds namespaces() and nested_types() on first use.
+        template<typename C, typename T = typename C::value_type>
+        explicit cache(C const& files, snapshot const& options)
+        {
+            std::vector<database const*> databases;
+
+            for (auto&& file : files)
+            {
+                databases.push_back(&m_databases.emplace_back(file, this));
+            }
+
+            m_snapshot = impl::snapshot_view::open(options.path, databases);
+
+            if (m_snapshot)
+            {
+                m_snapshot_index = true;
+                return;
+            }
+
+            default_type_filter filter;
+
+            for (auto&& db : m_databases)
+            {
+                add_types(db, filter);
+            }
+
+            build_index();
+            classify_types();
+            save_snapshot(options.path, std::move(databases));
+        }
+
+        template<typename C, typename T = typename C::value_type>
+        explicit cache(C const& files, parallel_load const& options) : cache{ files, default_type_filter{}, options }
+        {
         }
 
         template<typename C, typename T = typename C::value_type>
@@ -84,26 +206,24 @@ namespace winmd::reader
 
         TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
         {
-            auto ns = m_namespaces.find(type_namespace);
-
-            if (ns == m_namespaces.end())
+            if (m_snapshot_index)
             {
-                return {};
+                return m_snapshot->find(type_namespace, type_name);
             }
 
-            auto type = ns->second.types.find(type_name);
+            return m_index.find(type_namespace, type_name);
+        }
 
-            if (type == ns->second.types.end())
+        // Like find, but a name with architecture variants selects the first variant that supports any of
+        // arches, or returns a null TypeDef if none does.
+        TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name, Architecture const arches) const noexcept
+        {
+            if (m_snapshot_index)
             {
-				auto it = ns->second.types_same_name.find(type_name);
-				if (it != ns->second.types_same_name.end())
-				{
-					return it->second.at(0);
-				}
-                return {};
+                return m_snapshot->find(type_namespace, type_name, arches);
             }
 
-            return type->second;
+            return m_index.find(type_namespace, type_name, arches);
         }
 
         TypeDef find(std::string_view const& type_string) const
@@ -147,38 +267,47 @@ namespace winmd::reader
             return m_databases;
         }
 
-        auto const& namespaces() const noexcept
+        auto const& namespaces() const
         {
+            materialize();
             return m_namespaces;
         }
 
+        // Whether the indexes were loaded from a snapshot rather than built from the databases.
+        bool loaded_from_snapshot() const noexcept
+        {
+            return m_snapshot != nullptr;
+        }
+
+        // Removes a type from every index of the cache, including the nested types enclosed by it.
         void remove_type(std::string_view const& ns, std::string_view const& name)
         {
+            leave_snapshot_index();
             auto m = m_namespaces.find(ns);
             if (m == m_namespaces.end())
             {
                 return;
             }
-            auto& members = m->second;
 
-            auto remove = [&](auto&& collection, auto&& name)
+            auto const found = m->second.types.find(name);
+            if (found == m->second.types.end())
             {
-                auto pos = std::find_if(collection.begin(), collection.end(), [&](auto&& type)
-                    {
-                        return type.TypeName() == name;
-                    });
+                return;
+            }
+
+            TypeDef const type = found->second;
+            std::vector<TypeDef> candidates;
 
-                if (pos != collection.end())
+            for (auto&&[type_name, other] : m->second.types)
+            {
+                if (other != found->second)
                 {
-                    collection.erase(pos);
+                    candidates.push_back(other);
                 }
-            };
+            }
 
-            remove(members.interfaces, name);
-            remove(members.classes, name);
-            remove(members.enums, name);
-            remove(members.structs, name);
-            remove(members.delegates, name);
+            remove_nested_types(type);
+            rebuild_namespace(m, std::move(candidates), load_positions());
         }
 
         // This won't invalidate any existing database or row_base (e.g. TypeDef) instances
@@ -186,25 +315,68 @@ namespace winmd::reader
         template <typename TypeFilter>
         void add_database(std::string_view const& file, TypeFilter filter)
         {
+            leave_snapshot_index();
             auto& db = m_databases.emplace_back(file, this);
+
+            if (m_memo_budget)
+            {
+                db.enable_memo(m_memo_budget);
+            }
+
+            if (m_string_tables)
+            {
+                db.enable_string_table();
+            }
+
+            database_type_filter<TypeFilter> includes{ filter };
+
             for (auto&& type : db.TypeDef)
             {
-                if (type.Flags().value == 0 || is_nested(type) || !filter(type))
+                if (type.Flags().value == 0 || is_nested(type) || !includes(type))
+                {
+                    continue;
+                }
+
+                auto ns = m_namespaces.try_emplace(type.TypeNamespace()).first;
+                auto& members = ns->second;
+                auto const name = type.TypeName();
+
+                if (members.types.find(name) != members.types.end())
                 {
                     continue;
                 }
 
-                auto& ns = m_namespaces[type.TypeNamespace()];
-                auto[iter, inserted] = ns.types.try_emplace(type.TypeName(), type);
-                if (inserted)
+                // As in the constructors, architecture variants are grouped under their undecorated name.
+                add_type(members, type);
+
+                // An unclassified namespace picks the type up when it is classified.
+                if (members.classified())
+                {
+                    members.add_to_category(type);
+                }
+
+                auto const iter = members.types.find(name);
+                m_index.insert(ns->first, iter->first, &iter->second);
+
+                if (auto const pos = name.rfind('@'); pos != std::string_view::npos)
                 {
-                    add_type_to_members(type, ns);
+                    auto const variants = members.variants.find(name.substr(0, pos));
+                    m_index.insert(ns->first, variants->first, &variants->second);
                 }
             }
 
             for (auto&& row : db.NestedClass)
             {
-                m_nested_types[row.EnclosingType()].push_back(row.NestedType());
+                add_nested_type(row.EnclosingType(), row.NestedType());
+            }
+
+            // The new types may resolve references that previously failed, so every database is resolved again.
+            for (uint32_t arches = 1; arches <= Architecture::All; ++arches)
+            {
+                if (m_resolved_arches & (1u << arches))
+                {
+                    resolve_type_refs(static_cast<Architecture>(arches));
+                }
             }
         }
 
@@ -213,8 +385,128 @@ namespace winmd::reader
             add_database(file, default_type_filter{});
         }
 
-        std::vector<TypeDef> const& nested_types(TypeDef const& enclosing_type) const
+        // Removes a database and the types it contributed, rebuilding only the namespaces it has types in. A type
+        // of another database that was hidden because the removed one defined the same name earlier in load order
+        // takes its place, if filter includes it.
+        //
+        // Rows (TypeDef and the like), signatures and string_views into the removed database are invalidated, and
+        // type_handles into it resolve to a null TypeDef from then on. Rows and handles of the other databases stay
+        // valid. A namespace_members reference stays valid unless the namespace loses its last type, but iterators
+        // into its maps and category lists do not.
+        template <typename TypeFilter>
+        void remove_database(database const& db, TypeFilter filter)
+        {
+            update_database(find_database(db), m_databases.end(), filter);
+        }
+
+        void remove_database(database const& db)
         {
+            remove_database(db, default_type_filter{});
+        }
+
+        // Replaces a database with the current contents of file, which takes its place in load order, and returns
+        // the new database. The old database is invalidated as by remove_database. If file cannot be opened, the
+        // exception propagates and the cache is left unchanged.
+        template <typename TypeFilter>
+        database const& replace_database(database const& db, std::string_view const& file, TypeFilter filter)
+        {
+            auto const removed = find_database(db);
+            auto const added = m_databases.emplace(removed, file, this);
+            update_database(removed, added, filter);
+            return *added;
+        }
+
+        database const& replace_database(database const& db, std::string_view const& file)
+        {
+            return replace_database(db, file, default_type_filter{});
+        }
+
+        // A hook for a file watcher, such as one built on inotify or ReadDirectoryChangesW, which may call it from
+        // any thread when a file changes. The change is applied by the next reload_changed_databases.
+        void notify_file_changed(std::string_view const& path)
+        {
+            std::lock_guard const lock{ m_changed_lock };
+            m_changed_files.emplace(path);
+        }
+
+        // Replaces every database whose file was reported to notify_file_changed or was modified since it was
+        // opened, and removes those whose file no longer exists. Returns the number of databases replaced or
+        // removed. Like add_database, this must not run concurrently with readers of the cache.
+        template <typename TypeFilter>
+        std::size_t reload_changed_databases(TypeFilter filter)
+        {
+            std::set<std::string, std::less<>> reported;
+
+            {
+                std::lock_guard const lock{ m_changed_lock };
+                std::swap(reported, m_changed_files);
+            }
+
+            std::vector<database const*> changed;
+
+            for (auto&& db : m_databases)
+            {
+                std::error_code error;
+
+                if (!db.path().empty() && (reported.count(db.path()) || std::filesystem::last_write_time(db.path(), error) != db.write_time() || error))
+                {
+                    changed.push_back(&db);
+                }
+            }
+
+            for (auto&& db : changed)
+            {
+                std::string const path = db->path();
+                std::error_code error;
+
+                if (std::filesystem::exists(path, error))
+                {
+                    replace_database(*db, path, filter);
+                }
+                else
+                {
+                    remove_database(*db, filter);
+                }
+            }
+
+            return changed.size();
+        }
+
+        std::size_t reload_changed_databases()
+        {
+            return reload_changed_databases(default_type_filter{});
+        }
+
+        // Gives every database, including those added later, its own signature_memo with the given budget.
+        void enable_memo(std::size_t const budget)
+        {
+            m_memo_budget = budget;
+
+            for (auto&& db : m_databases)
+            {
+                db.enable_memo(budget);
+            }
+        }
+
+        // Gives every database, including those added later, a string table (see database::enable_string_table).
+        void enable_string_tables()
+        {
+            m_string_tables = true;
+
+            for (auto&& db : m_databases)
+            {
+                db.enable_string_table();
+            }
+        }
+
+        // Resolves every TypeRef row of every database once for the given architectures, so that later calls to
+        // find(TypeRef, arches) are a single indexed load. Databases added afterwards are resolved as well.
+        // Returns the number of rows that could not be resolved, such as references to System types.
+        std::size_t resolve_type_refs(Architecture arches = Architecture::All);
+
+        std::vector<type_handle> const& nested_types(TypeDef const& enclosing_type) const
+        {
+            materialize();
             auto it = m_nested_types.find(enclosing_type);
             if (it != m_nested_types.end())
             {
@@ -222,62 +514,1003 @@ namespace winmd::reader
             }
             else
             {
-                static const std::vector<TypeDef> empty;
+                static const std::vector<type_handle> empty;
                 return empty;
             }
         }
 
-        struct namespace_members
+        // The type nested directly in enclosing_type with the given name, which may be either its decorated
+        // TypeName or its TypeDisplayName. Decorated names take precedence, and among equal names the first
+        // NestedClass row wins, as with a linear search of nested_types.
+        TypeDef find_nested(TypeDef const& enclosing_type, std::string_view const& name) const noexcept
         {
-            std::map<std::string_view, TypeDef> types;
-            std::map<std::string_view, std::vector<TypeDef>> types_same_name;
-            std::vector<TypeDef> interfaces;
-            std::vector<TypeDef> classes;
-            std::vector<TypeDef> enums;
-            std::vector<TypeDef> structs;
-            std::vector<TypeDef> delegates;
-            std::vector<TypeDef> attributes;
-            std::vector<TypeDef> contracts;
-        };
+            if (m_snapshot_index)
+            {
+                return m_snapshot->find_nested(enclosing_type, name);
+            }
 
-        using namespace_type = std::pair<std::string_view const, namespace_members> const&;
+            auto const it = m_nested_names.find({ enclosing_type, name });
+            return it == m_nested_names.end() ? TypeDef{} : it->second.type.get();
+        }
 
-    private:
+        struct type_variant
+        {
+            type_handle type;
+            Architecture arches;
+        };
 
-        void add_type_to_members(TypeDef const& type, namespace_members& members)
+        // The same-named architecture variants of a type (Name@X86, Name@X64Arm64, ...) in load order. A variant is
+        // only kept if it supports an architecture that no earlier variant does, so there are at most three.
+        struct type_variants
         {
-            switch (get_category(type))
+            // The first variant that supports any of the architectures; None selects the first variant.
+            TypeDef find(Architecture const arches) const noexcept
             {
-            case category::interface_type:
-                members.interfaces.push_back(type);
-                return;
-            case category::class_type:
-                if (extends_type(type, "System"sv, "Attribute"sv))
+                uint8_t first = UINT8_MAX;
+
+                for (uint32_t bit = 0; bit < m_first.size(); ++bit)
                 {
-                    members.attributes.push_back(type);
-                    return;
+                    if (arches == Architecture::None || (arches & (1u << bit)))
+                    {
+                        first = std::min(first, m_first[bit]);
+                    }
                 }
-                members.classes.push_back(type);
-                return;
-            case category::enum_type:
-                members.enums.push_back(type);
-                return;
-            case category::struct_type:
-                if (get_attribute(type, "Windows.Foundation.Metadata"sv, "ApiContractAttribute"sv))
+
+                return first < m_count ? m_variants[first].type.get() : TypeDef{};
+            }
+
+            void add(TypeDef const& type, Architecture arches) noexcept
+            {
+                if (arches == Architecture::None)
                 {
-                    members.contracts.push_back(type);
-                    return;
+                    arches = Architecture::All;
+                }
+
+                bool useful{};
+
+                for (uint32_t bit = 0; bit < m_first.size(); ++bit)
+                {
+                    if ((arches & (1u << bit)) && m_first[bit] == UINT8_MAX)
+                    {
+                        m_first[bit] = m_count;
+                        useful = true;
+                    }
+                }
+
+                if (useful)
+                {
+                    m_variants[m_count++] = { type, arches };
                 }
-                members.structs.push_back(type);
-                return;
-            case category::delegate_type:
-                members.delegates.push_back(type);
-                return;
             }
-        }
 
-        std::list<database> m_databases;
-        std::map<std::string_view, namespace_members> m_namespaces;
-        std::map<TypeDef, std::vector<TypeDef>> m_nested_types;
-    };
+            TypeDef front() const noexcept
+            {
+                return m_variants[0].type.get();
+            }
+
+            type_variant const* begin() const noexcept
+            {
+                return m_variants.data();
+            }
+
+            type_variant const* end() const noexcept
+            {
+                return m_variants.data() + m_count;
+            }
+
+            std::size_t size() const noexcept
+            {
+                return m_count;
+            }
+
+        private:
+
+            std::array<type_variant, 3> m_variants{};
+            std::array<uint8_t, 3> m_first{ UINT8_MAX, UINT8_MAX, UINT8_MAX };
+            uint8_t m_count{};
+        };
+
+        struct namespace_members;
+
+        // One of the category lists of a namespace_members. The first use of any list of a lazily classified
+        // namespace classifies all of them, which is safe to race from several threads.
+        struct category_list
+        {
+            category_list(category_list const&) = delete;
+            category_list& operator=(category_list const&) = delete;
+
+            std::vector<type_handle> const& get() const;
+
+            operator std::vector<type_handle> const&() const
+            {
+                return get();
+            }
+
+            auto begin() const
+            {
+                return get().begin();
+            }
+
+            auto end() const
+            {
+                return get().end();
+            }
+
+            std::size_t size() const
+            {
+                return get().size();
+            }
+
+            bool empty() const
+            {
+                return get().empty();
+            }
+
+            type_handle const& operator[](std::size_t const index) const
+            {
+                return get()[index];
+            }
+
+        private:
+
+            friend struct cache;
+            friend struct namespace_members;
+
+            explicit category_list(namespace_members const* owner) noexcept : m_owner{ owner }
+            {
+            }
+
+            namespace_members const* m_owner;
+            mutable std::vector<type_handle> m_types;
+        };
+
+        // Stored in place in the cache's std::map, which never moves its nodes; the lists point back to it.
+        struct namespace_members
+        {
+            namespace_members() noexcept = default;
+            namespace_members(namespace_members const&) = delete;
+            namespace_members& operator=(namespace_members const&) = delete;
+
+            std::map<std::string_view, type_handle> types;
+            std::map<std::string_view, type_variants> variants;
+            category_list interfaces{ this };
+            category_list classes{ this };
+            category_list enums{ this };
+            category_list structs{ this };
+            category_list delegates{ this };
+            category_list attributes{ this };
+            category_list contracts{ this };
+
+            bool classified() const noexcept
+            {
+                return m_classified.load(std::memory_order_acquire);
+            }
+
+        private:
+
+            friend struct cache;
+            friend struct category_list;
+
+            void classify() const
+            {
+                if (classified())
+                {
+                    return;
+                }
+
+                std::call_once(m_classify_once, [&]
+                {
+                    for (auto&&[name, type] : types)
+                    {
+                        add_to_category(type);
+                    }
+
+                    m_classified.store(true, std::memory_order_release);
+                });
+            }
+
+            void add_to_category(TypeDef const& type) const
+            {
+                switch (get_category(type))
+                {
+                case category::interface_type:
+                    interfaces.m_types.push_back(type);
+                    return;
+                case category::class_type:
+                    if (extends_type(type, "System"sv, "Attribute"sv))
+                    {
+                        attributes.m_types.push_back(type);
+                        return;
+                    }
+                    classes.m_types.push_back(type);
+                    return;
+                case category::enum_type:
+                    enums.m_types.push_back(type);
+                    return;
+                case category::struct_type:
+                    if (get_attribute(type, "Windows.Foundation.Metadata"sv, "ApiContractAttribute"sv))
+                    {
+                        contracts.m_types.push_back(type);
+                        return;
+                    }
+                    structs.m_types.push_back(type);
+                    return;
+                case category::delegate_type:
+                    delegates.m_types.push_back(type);
+                    return;
+                }
+            }
+
+            std::array<category_list*, 7> lists() noexcept
+            {
+                return { &interfaces, &classes, &enums, &structs, &delegates, &attributes, &contracts };
+            }
+
+            mutable std::once_flag m_classify_once;
+            mutable std::atomic<bool> m_classified{};
+        };
+
+        using namespace_type = std::pair<std::string_view const, namespace_members> const&;
+
+    private:
+
+        // Open-addressing hash table over every (namespace, name) pair in m_namespaces. Entries point into the
+        // std::map nodes, which never move, and keep the pre-computed hash so that probing compares strings
+        // only on a full hash match. A name may refer both to a type and to its architecture variants; as with
+        // the maps, the exact type wins.
+        struct type_index
+        {
+            TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+            {
+                auto const entry = find_entry(type_namespace, type_name);
+
+                if (!entry)
+                {
+                    return {};
+                }
+
+                return entry->type ? entry->type->get() : entry->variants->front();
+            }
+
+            TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name, Architecture const arches) const noexcept
+            {
+                auto const entry = find_entry(type_namespace, type_name);
+
+                if (!entry)
+                {
+                    return {};
+                }
+
+                return entry->type ? entry->type->get() : entry->variants->find(arches);
+            }
+
+            void insert(std::string_view const& type_namespace, std::string_view const& type_name, type_handle const* type)
+            {
+                find_or_insert(type_namespace, type_name).type = type;
+            }
+
+            void insert(std::string_view const& type_namespace, std::string_view const& type_name, type_variants const* variants)
+            {
+                find_or_insert(type_namespace, type_name).variants = variants;
+            }
+
+            // Removes the entry for the type and the variants of that name, shifting later entries of the same
+            // probe sequence back so that lookups need no tombstones.
+            void erase(std::string_view const& type_namespace, std::string_view const& type_name) noexcept
+            {
+                auto const found = find_entry(type_namespace, type_name);
+
+                if (!found)
+                {
+                    return;
+                }
+
+                auto const mask = m_entries.size() - 1;
+                auto hole = static_cast<std::size_t>(found - m_entries.data());
+
+                for (auto position = (hole + 1) & mask; m_entries[position].type || m_entries[position].variants; position = (position + 1) & mask)
+                {
+                    // An entry may move into the hole unless its home slot lies cyclically after the hole.
+                    auto const home = m_entries[position].hash & mask;
+
+                    if (((position - home) & mask) >= ((position - hole) & mask))
+                    {
+                        m_entries[hole] = m_entries[position];
+                        hole = position;
+                    }
+                }
+
+                m_entries[hole] = {};
+                --m_count;
+            }
+
+            void clear() noexcept
+            {
+                m_entries.clear();
+                m_count = 0;
+            }
+
+            void reserve(std::size_t const count)
+            {
+                std::size_t capacity = 16;
+
+                while (capacity < count * 2)
+                {
+                    capacity *= 2;
+                }
+
+                if (capacity > m_entries.size())
+                {
+                    rehash(capacity);
+                }
+            }
+
+        private:
+
+            struct entry
+            {
+                uint64_t hash{};
+                std::string_view type_namespace;
+                std::string_view name;
+                type_handle const* type{};
+                type_variants const* variants{};
+            };
+
+            entry const* find_entry(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+            {
+                if (m_entries.empty())
+                {
+                    return nullptr;
+                }
+
+                auto const hash = hash_key(type_namespace, type_name);
+                auto const mask = m_entries.size() - 1;
+
+                for (auto position = hash & mask;; position = (position + 1) & mask)
+                {
+                    auto const& entry = m_entries[position];
+
+                    if (!entry.type && !entry.variants)
+                    {
+                        return nullptr;
+                    }
+
+                    if (entry.hash == hash && entry.name == type_name && entry.type_namespace == type_namespace)
+                    {
+                        return &entry;
+                    }
+                }
+            }
+
+            static uint64_t hash_key(std::string_view const& type_namespace, std::string_view const& type_name) noexcept
+            {
+                // The separator keeps ("A.B", "C") and ("A", "B.C") from being the same byte sequence.
+                return impl::hash_string(type_name, impl::hash_string("\0"sv, impl::hash_string(type_namespace)));
+            }
+
+            entry& find_or_insert(std::string_view const& type_namespace, std::string_view const& type_name)
+            {
+                reserve(m_count + 1);
+                auto const hash = hash_key(type_namespace, type_name);
+                auto const mask = m_entries.size() - 1;
+
+                for (auto position = hash & mask;; position = (position + 1) & mask)
+                {
+                    auto& entry = m_entries[position];
+
+                    if (!entry.type && !entry.variants)
+                    {
+                        ++m_count;
+                        entry.hash = hash;
+                        entry.type_namespace = type_namespace;
+                        entry.name = type_name;
+                        return entry;
+                    }
+
+                    if (entry.hash == hash && entry.name == type_name && entry.type_namespace == type_namespace)
+                    {
+                        return entry;
+                    }
+                }
+            }
+
+            void rehash(std::size_t const capacity)
+            {
+                std::vector<entry> previous(capacity);
+                std::swap(previous, m_entries);
+                auto const mask = m_entries.size() - 1;
+
+                for (auto&& entry : previous)
+                {
+                    if (!entry.type && !entry.variants)
+                    {
+                        continue;
+                    }
+
+                    auto position = entry.hash & mask;
+
+                    while (m_entries[position].type || m_entries[position].variants)
+                    {
+                        position = (position + 1) & mask;
+                    }
+
+                    m_entries[position] = entry;
+                }
+            }
+
+            std::vector<entry> m_entries;
+            std::size_t m_count{};
+        };
+
+        struct nested_key
+        {
+            type_handle enclosing_type;
+            std::string_view name;
+
+            bool operator==(nested_key const& other) const noexcept
+            {
+                return enclosing_type == other.enclosing_type && name == other.name;
+            }
+        };
+
+        struct nested_key_hash
+        {
+            std::size_t operator()(nested_key const& key) const noexcept
+            {
+                auto const row = (uint64_t{ key.enclosing_type.database_id() } << 32) | key.enclosing_type.index();
+                return static_cast<std::size_t>(impl::hash_string(key.name) ^ (row * 0x9e3779b97f4a7c15));
+            }
+        };
+
+        struct nested_name
+        {
+            type_handle type;
+            bool decorated{};
+        };
+
+        void add_nested_type(TypeDef const& enclosing_type, TypeDef const& nested_type)
+        {
+            m_nested_types[enclosing_type].push_back(nested_type);
+
+            auto const name = nested_type.TypeName();
+            auto[it, inserted] = m_nested_names.try_emplace({ enclosing_type, name }, nested_name{ nested_type, true });
+
+            if (!inserted && !it->second.decorated)
+            {
+                it->second = { nested_type, true };
+            }
+
+            auto const display_name = nested_type.TypeDisplayName();
+
+            if (display_name != name)
+            {
+                m_nested_names.try_emplace({ enclosing_type, display_name }, nested_name{ nested_type, false });
+            }
+        }
+
+        template <typename TypeFilter>
+        void add_types(database const& db, TypeFilter& filter)
+        {
+            database_type_filter<TypeFilter> includes{ filter };
+
+            for (auto&& type : db.TypeDef)
+            {
+                if (type.Flags().value == 0 || is_nested(type) || !includes(type))
+                {
+                    continue;
+                }
+
+                add_type(m_namespaces[type.TypeNamespace()], type);
+            }
+
+            for (auto&& row : db.NestedClass)
+            {
+                add_nested_type(row.EnclosingType(), row.NestedType());
+            }
+        }
+
+        void classify_types()
+        {
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                members.classify();
+            }
+        }
+
+        // The mapped index cannot change, so from here on the cache is served from its own containers.
+        void leave_snapshot_index()
+        {
+            if (m_snapshot_index)
+            {
+                materialize();
+                build_index();
+                m_snapshot_index = false;
+            }
+        }
+
+        std::list<database>::iterator find_database(database const& db)
+        {
+            auto const found = std::find_if(m_databases.begin(), m_databases.end(), [&](database const& item)
+            {
+                return &item == &db;
+            });
+
+            if (found == m_databases.end())
+            {
+                impl::throw_invalid("Database '", db.path(), "' does not belong to this cache");
+            }
+
+            return found;
+        }
+
+        std::unordered_map<database const*, std::size_t> load_positions() const
+        {
+            std::unordered_map<database const*, std::size_t> positions;
+
+            for (auto&& db : m_databases)
+            {
+                positions.emplace(&db, positions.size());
+            }
+
+            return positions;
+        }
+
+        void remove_nested_types(TypeDef const& enclosing_type)
+        {
+            auto const nested = m_nested_types.find(enclosing_type);
+
+            if (nested == m_nested_types.end())
+            {
+                return;
+            }
+
+            for (auto&& nested_type : nested->second)
+            {
+                m_nested_names.erase({ enclosing_type, nested_type->TypeName() });
+                m_nested_names.erase({ enclosing_type, nested_type->TypeDisplayName() });
+            }
+
+            m_nested_types.erase(nested);
+        }
+
+        // Removes removed and adds added, which is already in m_databases at its place in load order; either may be
+        // m_databases.end(). Only the namespaces that either database has types in are rebuilt.
+        template <typename TypeFilter>
+        void update_database(std::list<database>::iterator const removed, std::list<database>::iterator const added, TypeFilter& filter)
+        {
+            leave_snapshot_index();
+
+            struct update
+            {
+                std::vector<TypeDef> candidates;
+
+                // The names that the removed database held, which another database may now provide.
+                std::set<std::string_view> released;
+            };
+
+            std::map<std::string, update, std::less<>> updates;
+            bool released{};
+
+            if (removed != m_databases.end())
+            {
+                for (auto&& type : removed->TypeDef)
+                {
+                    if (type.Flags().value == 0 || is_nested(type))
+                    {
+                        continue;
+                    }
+
+                    auto const ns = m_namespaces.find(type.TypeNamespace());
+
+                    if (ns == m_namespaces.end())
+                    {
+                        continue;
+                    }
+
+                    auto const found = ns->second.types.find(type.TypeName());
+
+                    if (found != ns->second.types.end() && found->second.database_id() == removed->id())
+                    {
+                        updates[std::string{ ns->first }].released.insert(found->first);
+                        released = true;
+                    }
+                }
+            }
+
+            if (added != m_databases.end())
+            {
+                database_type_filter<TypeFilter> includes{ filter };
+
+                for (auto&& type : added->TypeDef)
+                {
+                    if (type.Flags().value == 0 || is_nested(type) || !includes(type))
+                    {
+                        continue;
+                    }
+
+                    updates[std::string{ type.TypeNamespace() }].candidates.push_back(type);
+                }
+            }
+
+            if (released)
+            {
+                database_type_filter<TypeFilter> includes{ filter };
+
+                for (auto db = m_databases.begin(); db != m_databases.end(); ++db)
+                {
+                    if (db == removed || db == added)
+                    {
+                        continue;
+                    }
+
+                    for (auto&& type : db->TypeDef)
+                    {
+                        if (type.Flags().value == 0 || is_nested(type))
+                        {
+                            continue;
+                        }
+
+                        auto const update = updates.find(type.TypeNamespace());
+
+                        if (update != updates.end() && update->second.released.count(type.TypeName()) && includes(type))
+                        {
+                            update->second.candidates.push_back(type);
+                        }
+                    }
+                }
+            }
+
+            auto const positions = load_positions();
+
+            for (auto&&[namespace_name, update] : updates)
+            {
+                auto const ns = m_namespaces.find(namespace_name);
+
+                if (ns != m_namespaces.end())
+                {
+                    for (auto&&[name, type] : ns->second.types)
+                    {
+                        if (removed == m_databases.end() || type.database_id() != removed->id())
+                        {
+                            update.candidates.push_back(type);
+                        }
+                    }
+                }
+
+                rebuild_namespace(ns, std::move(update.candidates), positions);
+            }
+
+            if (removed != m_databases.end())
+            {
+                for (auto&& row : removed->NestedClass)
+                {
+                    remove_nested_types(row.EnclosingType());
+                }
+
+                m_databases.erase(removed);
+            }
+
+            if (added != m_databases.end())
+            {
+                if (m_memo_budget)
+                {
+                    added->enable_memo(m_memo_budget);
+                }
+
+                if (m_string_tables)
+                {
+                    added->enable_string_table();
+                }
+
+                for (auto&& row : added->NestedClass)
+                {
+                    add_nested_type(row.EnclosingType(), row.NestedType());
+                }
+            }
+
+            // Resolved references may point into the removed database, or may now resolve into the added one.
+            for (uint32_t arches = 1; arches <= Architecture::All; ++arches)
+            {
+                if (m_resolved_arches & (1u << arches))
+                {
+                    resolve_type_refs(static_cast<Architecture>(arches));
+                }
+            }
+        }
+
+        // Replaces the types of a namespace with candidates, which need not be in any order, and brings the index
+        // and, if the namespace is classified, its category lists in line. ns is m_namespaces.end() for a namespace
+        // that does not exist yet. The namespace is erased if no candidates remain.
+        void rebuild_namespace(std::map<std::string_view, namespace_members>::iterator ns, std::vector<TypeDef>&& candidates, std::unordered_map<database const*, std::size_t> const& positions)
+        {
+            if (ns != m_namespaces.end())
+            {
+                for (auto&&[type_name, type] : ns->second.types)
+                {
+                    m_index.erase(ns->first, type_name);
+                }
+
+                for (auto&&[variants_name, variants] : ns->second.variants)
+                {
+                    m_index.erase(ns->first, variants_name);
+                }
+            }
+
+            if (candidates.empty())
+            {
+                if (ns != m_namespaces.end())
+                {
+                    m_namespaces.erase(ns);
+                }
+
+                return;
+            }
+
+            // As when the cache is built, the first database in load order to define a name provides it.
+            std::sort(candidates.begin(), candidates.end(), [&](TypeDef const& left, TypeDef const& right)
+            {
+                return std::make_pair(positions.at(&left.get_database()), left.index()) < std::make_pair(positions.at(&right.get_database()), right.index());
+            });
+
+            if (ns == m_namespaces.end())
+            {
+                ns = m_namespaces.try_emplace(candidates.front().TypeNamespace()).first;
+            }
+
+            auto& members = ns->second;
+            members.types.clear();
+            members.variants.clear();
+
+            for (auto&& type : candidates)
+            {
+                add_type(members, type);
+            }
+
+            // The key may point into a database that is about to be removed, so it is taken from a remaining type.
+            auto const key = candidates.front().TypeNamespace();
+
+            if (key.data() != ns->first.data())
+            {
+                auto node = m_namespaces.extract(ns);
+                node.key() = key;
+                ns = m_namespaces.insert(std::move(node)).position;
+            }
+
+            if (members.classified())
+            {
+                for (auto&& list : members.lists())
+                {
+                    list->m_types.clear();
+                }
+
+                for (auto&&[type_name, type] : members.types)
+                {
+                    members.add_to_category(type);
+                }
+            }
+
+            for (auto&&[type_name, type] : members.types)
+            {
+                m_index.insert(ns->first, type_name, &type);
+            }
+
+            for (auto&&[variants_name, variants] : members.variants)
+            {
+                m_index.insert(ns->first, variants_name, &variants);
+            }
+        }
+
+        // Best effort: a snapshot that cannot be written only means that the next start builds the cache again.
+        void save_snapshot(std::string const& path, std::vector<database const*>&& databases)
+        {
+            impl::snapshot_writer writer{ std::move(databases) };
+            std::size_t count{};
+
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                count += members.types.size() + members.variants.size();
+            }
+
+            writer.reserve(count, m_nested_names.size());
+
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                impl::snapshot_namespace ns{};
+                ns.name = writer.add_string(namespace_name);
+                ns.first_member = static_cast<uint32_t>(writer.members.size());
+
+                for (auto&&[name, type] : members.types)
+                {
+                    auto const name_string = writer.add_string(name);
+                    writer.add_entry(ns.name, name_string).member = static_cast<uint32_t>(writer.members.size());
+                    writer.members.push_back({ name_string, writer.add_type(type) });
+                }
+
+                ns.last_member = static_cast<uint32_t>(writer.members.size());
+                ns.first_variant_list = static_cast<uint32_t>(writer.variant_lists.size());
+
+                for (auto&&[name, variants] : members.variants)
+                {
+                    impl::snapshot_variant_list list{ writer.add_string(name), static_cast<uint32_t>(writer.variants.size()), 0 };
+
+                    for (auto&& variant : variants)
+                    {
+                        writer.variants.push_back({ writer.add_type(variant.type), static_cast<uint32_t>(variant.arches) });
+                    }
+
+                    list.last = static_cast<uint32_t>(writer.variants.size());
+                    writer.add_entry(ns.name, list.name).variant_list = static_cast<uint32_t>(writer.variant_lists.size());
+                    writer.variant_lists.push_back(list);
+                }
+
+                ns.last_variant_list = static_cast<uint32_t>(writer.variant_lists.size());
+                auto const lists = members.lists();
+
+                for (std::size_t list = 0; list < lists.size(); ++list)
+                {
+                    ns.categories[list] = static_cast<uint32_t>(writer.categories.size());
+
+                    for (auto&& type : *lists[list])
+                    {
+                        writer.categories.push_back(writer.add_type(type));
+                    }
+                }
+
+                ns.categories.back() = static_cast<uint32_t>(writer.categories.size());
+                writer.namespaces.push_back(ns);
+            }
+
+            for (auto&&[enclosing_type, nested_types] : m_nested_types)
+            {
+                auto const enclosing = writer.add_type(enclosing_type);
+
+                for (auto&& nested_type : nested_types)
+                {
+                    writer.nested.push_back({ enclosing, writer.add_type(nested_type) });
+                }
+            }
+
+            for (auto&&[key, value] : m_nested_names)
+            {
+                writer.add_nested_entry(writer.add_type(key.enclosing_type), writer.add_string(key.name), writer.add_type(value.type), value.decorated);
+            }
+
+            writer.save(path);
+        }
+
+        // Builds the containers behind namespaces() and nested_types() from the snapshot the first time they are
+        // needed. The records are already classified and sorted, so this does no attribute or name lookups.
+        void materialize() const
+        {
+            if (!m_snapshot)
+            {
+                return;
+            }
+
+            std::call_once(m_materialized, [&]
+            {
+                auto const& snapshot = *m_snapshot;
+
+                for (uint32_t index = 0; index < snapshot.header->namespaces; ++index)
+                {
+                    auto const& ns = snapshot.namespaces[index];
+                    auto& members = m_namespaces.try_emplace(m_namespaces.end(), snapshot.string(ns.name))->second;
+
+                    for (auto member = ns.first_member; member != ns.last_member; ++member)
+                    {
+                        members.types.emplace_hint(members.types.end(), snapshot.string(snapshot.members[member].name), snapshot.type(snapshot.members[member].type));
+                    }
+
+                    for (auto list = ns.first_variant_list; list != ns.last_variant_list; ++list)
+                    {
+                        auto const& source = snapshot.variant_lists[list];
+                        auto& variants = members.variants.emplace_hint(members.variants.end(), snapshot.string(source.name), type_variants{})->second;
+
+                        for (auto variant = source.first; variant != source.last; ++variant)
+                        {
+                            variants.add(snapshot.type(snapshot.variants[variant].type), static_cast<Architecture>(snapshot.variants[variant].arches));
+                        }
+                    }
+
+                    auto const lists = members.lists();
+
+                    for (std::size_t list = 0; list < lists.size(); ++list)
+                    {
+                        for (auto category = ns.categories[list]; category != ns.categories[list + 1]; ++category)
+                        {
+                            lists[list]->m_types.push_back(snapshot.type(snapshot.categories[category]));
+                        }
+                    }
+
+                    members.m_classified = true;
+                }
+
+                for (uint32_t index = 0; index < snapshot.header->nested; ++index)
+                {
+                    m_nested_types[snapshot.type(snapshot.nested[index].enclosing_type)].push_back(snapshot.type(snapshot.nested[index].nested_type));
+                }
+
+                for (uint32_t position = 0; position < snapshot.header->nested_index_capacity; ++position)
+                {
+                    auto const& entry = snapshot.nested_index[position];
+
+                    if (entry.type.file != impl::snapshot_none)
+                    {
+                        m_nested_names.try_emplace({ snapshot.type(entry.enclosing_type), snapshot.string(entry.name) }, nested_name{ snapshot.type(entry.type), entry.decorated != 0 });
+                    }
+                }
+            });
+        }
+
+        void build_index()
+        {
+            std::size_t count{};
+
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                count += members.types.size() + members.variants.size();
+            }
+
+            m_index.clear();
+            m_index.reserve(count);
+
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                for (auto&&[name, type] : members.types)
+                {
+                    m_index.insert(namespace_name, name, &type);
+                }
+
+                for (auto&&[name, variants] : members.variants)
+                {
+                    m_index.insert(namespace_name, name, &variants);
+                }
+            }
+        }
+
+        struct file_index
+        {
+            std::list<database> databases;
+            std::map<std::string_view, std::vector<TypeDef>> namespaces;
+            std::vector<std::pair<TypeDef, TypeDef>> nested_types;
+        };
+
+        static void add_type(namespace_members& ns, TypeDef const& type)
+        {
+            std::string_view name = type.TypeName();
+
+            if (!ns.types.try_emplace(name, type).second)
+            {
+                return;
+            }
+
+            auto fpos = name.rfind('@');
+            if (fpos != std::string_view::npos)
+            {
+                ns.variants[name.substr(0, fpos)].add(type, type.get_database().supported_architectures(type));
+            }
+        }
+
+        std::list<database> m_databases;
+
+        // Filled on first use when the cache was loaded from a snapshot.
+        mutable std::map<std::string_view, namespace_members> m_namespaces;
+        mutable std::map<type_handle, std::vector<type_handle>> m_nested_types;
+        mutable std::unordered_map<nested_key, nested_name, nested_key_hash> m_nested_names;
+        type_index m_index;
+        std::unique_ptr<impl::snapshot_view> m_snapshot;
+        mutable std::once_flag m_materialized;
+        bool m_snapshot_index{};
+        std::size_t m_memo_budget{};
+        bool m_string_tables{};
+        uint32_t m_resolved_arches{};
+        std::mutex m_changed_lock;
+        std::set<std::string, std::less<>> m_changed_files;
+    };
+
+    inline std::vector<type_handle> const& cache::category_list::get() const
+    {
+        m_owner->classify();
+        return m_types;
+    }
 }
\ No newline at end of file
@@ -1,6 +1,22 @@
 
 namespace winmd::reader
 {
+    // The key column of each table that is sorted by a coded index and searched with equal_range below.
+    template <typename Row> inline constexpr uint32_t sorted_column_v = UINT32_MAX;
+    template <> inline constexpr uint32_t sorted_column_v<CustomAttribute> = 0;
+    template <> inline constexpr uint32_t sorted_column_v<Constant> = 1;
+    template <> inline constexpr uint32_t sorted_column_v<FieldMarshal> = 0;
+    template <> inline constexpr uint32_t sorted_column_v<GenericParam> = 2;
+    template <> inline constexpr uint32_t sorted_column_v<MethodSemantics> = 2;
+
+    template <typename Row, typename T>
+    std::pair<Row, Row> equal_range(table<Row> const& rows, coded_index<T> const& value) noexcept
+    {
+        static_assert(sorted_column_v<Row> != UINT32_MAX);
+        auto const[first, last] = rows.equal_range_rows(sorted_column_v<Row>, value.value());
+        return { rows.begin() + first, rows.begin() + last };
+    }
+
     template <typename Row>
     template <typename T>
     auto row_base<Row>::get_list(uint32_t const column) const
@@ -28,19 +44,8 @@ namespace winmd::reader
     template <typename T, uint32_t ParentColumn>
     auto row_base<Row>::get_parent_row() const
     {
-        struct compare
-        {
-            bool operator()(T const& lhs, uint32_t rhs) const noexcept
-            {
-                return lhs.template get_value<uint32_t>(ParentColumn) < rhs;
-            }
-            bool operator()(uint32_t lhs, T const& rhs) const noexcept
-            {
-                return lhs < rhs.template get_value<uint32_t>(ParentColumn);
-            }
-        };
         auto const& map = get_database().template get_table<T>();
-        return std::upper_bound(map.begin(), map.end(), index() + 1, compare{}) - 1;
+        return map.begin() + (map.upper_bound_row(ParentColumn, index() + 1) - 1);
     }
 
     inline auto TypeDef::GenericParam() const
@@ -55,20 +60,9 @@ namespace winmd::reader
 
     inline auto TypeDef::InterfaceImpl() const
     {
-        struct compare
-        {
-            bool operator()(uint32_t const left, reader::InterfaceImpl const& right) noexcept
-            {
-                return left < right.get_value<uint32_t>(0);
-            }
-
-            bool operator()(reader::InterfaceImpl const& left, uint32_t const right) noexcept
-            {
-                return left.get_value<uint32_t>(0) < right;
-            }
-        };
-
-        return equal_range(get_database().InterfaceImpl, index() + 1, compare{});
+        auto const& rows = get_database().InterfaceImpl;
+        auto const[first, last] = rows.equal_range_rows(0, index() + 1);
+        return std::pair{ rows.begin() + first, rows.begin() + last };
     }
 
     inline auto TypeDef::FieldList() const
@@ -82,36 +82,56 @@ namespace winmd::reader
             }
             else if (auto type_index = std::get_if<coded_index<TypeDefOrRef>>(&type))
             {
-                if ((type_index->type() == TypeDefOrRef::TypeRef && type_index->TypeRef().TypeNamespace() == "System" && type_index->TypeRef().TypeName() == "Type") ||
-                    (type_index->type() == TypeDefOrRef::TypeDef && type_index->TypeDef().TypeNamespace() == "System" && type_index->TypeDef().TypeName() == "Type"))
+                if ((type_index->type() == TypeDefOrRef::TypeRef && type_index->TypeRef().has_name("System", "Type")) ||
+                    (type_index->type() == TypeDefOrRef::TypeDef && type_index->TypeDef().has_name("System", "Type")))
                 {
                     return SystemType{ read<std::string_view>(data) };
                 }
                 else
                 {
                     // Should be an enum. Resolve it.
-                    auto resolve_type = [&db, &type_index]() -> TypeDef
-                    {
-                        if (type_index->type() == TypeDefOrRef::TypeDef)
-                        {
-                            return type_index->TypeDef();
-                        }
-                        auto const& typeref = type_index->TypeRef();
-                        return db.get_cache().find_required(typeref.TypeNamespace(), typeref.TypeName());
-                    };
-                    TypeDef const& enum_type = resolve_type();
-                    if (!enum_type.is_enum())
+                    auto const enum_type = resolve_enum(db, *type_index);
+                    auto const underlying_type = enum_type.get_database().enum_underlying_type(enum_type);
+                    if (underlying_type == ElementType::End)
                     {
                         impl::throw_invalid("CustomAttribute params that are TypeDefOrRef must be an enum or System.Type");
                     }
 
-                    auto const& enum_def = enum_type.get_enum_definition();
-                    return EnumValue{ enum_def, read_enum(enum_def.m_underlying_type, data) };
+                    return EnumValue{ EnumDefinition{ enum_type, underlying_type }, read_enum(underlying_type, data) };
                 }
             }
             impl::throw_invalid("Custom attribute params must be primitives, enums, or System.Type");
         }
 
+        // Prefers the resolution cache::resolve_type_refs recorded, then the cache, and only then the database
+        // itself, which is all a database opened without a cache has.
+        static TypeDef resolve_enum(database const& db, coded_index<TypeDefOrRef> const& type)
+        {
+            if (type.type() == TypeDefOrRef::TypeDef)
+            {
+                return type.TypeDef();
+            }
+
+            auto const& typeref = type.TypeRef();
+
+            if (auto const resolved = db.resolved_type_ref(typeref, Architecture::None); resolved && *resolved)
+            {
+                return *resolved;
+            }
+
+            if (db.has_cache())
+            {
+                return db.get_cache().find_required(typeref.TypeNamespace(), typeref.TypeName());
+            }
+
+            if (auto const local = db.find_type(typeref.TypeNamespace(), typeref.TypeName()))
+            {
+                return local;
+            }
+
+            impl::throw_invalid("Type '", typeref.TypeNamespace(), ".", typeref.TypeName(), "' could not be found");
+        }
+
         static value_type read_primitive(ElementType type, byte_view& data)
         {
             switch (type)
@@ -204,10 +224,10 @@ namespace winmd::reader
 
     struct FixedArgSig
     {
-        using value_type = std::variant<ElemSig, std::vector<ElemSig>>;
+        using value_type = std::variant<ElemSig, std::pmr::vector<ElemSig>>;
 
-        FixedArgSig(database const& db, ParamSig const& ctor_param, byte_view& data)
-            : value{ read_arg(db, ctor_param, data) }
+        FixedArgSig(database const& db, ParamSig const& ctor_param, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : value{ read_arg(db, ctor_param, data, resource) }
         {}
 
         FixedArgSig(ElemSig::SystemType type)
@@ -218,16 +238,16 @@ namespace winmd::reader
             : value{ ElemSig{ enum_def, data } }
         {}
 
-        FixedArgSig(ElementType type, bool is_array, byte_view& data)
-            : value{ read_arg(type, is_array, data) }
+        FixedArgSig(ElementType type, bool is_array, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : value{ read_arg(type, is_array, data, resource) }
         {}
 
-        static value_type read_arg(database const& db, ParamSig const& ctor_param, byte_view& data)
+        static value_type read_arg(database const& db, ParamSig const& ctor_param, byte_view& data, std::pmr::memory_resource* resource)
         {
             auto const& type_sig = ctor_param.Type();
             if (type_sig.is_szarray())
             {
-                std::vector<ElemSig> elems;
+                std::pmr::vector<ElemSig> elems(resource);
                 auto const num_elements = read<uint32_t>(data);
                 if (num_elements != 0xffffffff)
                 {
@@ -249,11 +269,11 @@ namespace winmd::reader
             }
         }
 
-        static value_type read_arg(ElementType type, bool is_array, byte_view& data)
+        static value_type read_arg(ElementType type, bool is_array, byte_view& data, std::pmr::memory_resource* resource)
         {
             if (is_array)
             {
-                std::vector<ElemSig> elems;
+                std::pmr::vector<ElemSig> elems(resource);
                 auto const num_elements = read<uint32_t>(data);
                 if (num_elements != 0xffffffff)
                 {
@@ -280,15 +300,32 @@ namespace winmd::reader
 
     struct NamedArgSig
     {
-        NamedArgSig(database const& db, byte_view& data)
-            : value{ parse_value(db, data) }
+        NamedArgSig(database const& db, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : value{ parse_value(db, data, resource) }
         {}
 
         std::string_view name;
         FixedArgSig value;
 
     private:
-        FixedArgSig parse_value(database const& db, byte_view& data)
+        static TypeDef find_enum(database const& db, std::string_view const& type_string)
+        {
+            if (db.has_cache())
+            {
+                return db.get_cache().find(type_string);
+            }
+
+            auto const pos = type_string.rfind('.');
+
+            if (pos == std::string_view::npos)
+            {
+                impl::throw_invalid("Type '", type_string, "' is missing a namespace qualifier");
+            }
+
+            return db.find_type(type_string.substr(0, pos), type_string.substr(pos + 1));
+        }
+
+        FixedArgSig parse_value(database const& db, byte_view& data, std::pmr::memory_resource* resource)
         {
             auto const field_or_prop = read<ElementType>(data);
             if (field_or_prop != ElementType::Field && field_or_prop != ElementType::Property)
@@ -307,17 +344,18 @@ namespace winmd::reader
             {
                 auto type_string = read<std::string_view>(data);
                 name = read<std::string_view>(data);
-                auto type_def = db.get_cache().find(type_string);
+                auto type_def = find_enum(db, type_string);
                 if (!type_def)
                 {
                     impl::throw_invalid("CustomAttribute named param referenced unresolved enum type");
                 }
-                if (!type_def.is_enum())
+                auto const underlying_type = type_def.get_database().enum_underlying_type(type_def);
+                if (underlying_type == ElementType::End)
                 {
                     impl::throw_invalid("CustomAttribute named param referenced non-enum type");
                 }
 
-                return FixedArgSig{ type_def.get_enum_definition(), data };
+                return FixedArgSig{ EnumDefinition{ type_def, underlying_type }, data };
             }
 
             default:
@@ -332,7 +370,7 @@ namespace winmd::reader
                     impl::throw_invalid("CustomAttribute named param must be a primitive, System.Type, or an Enum");
                 }
                 name = read<std::string_view>(data);
-                return FixedArgSig{ type, is_array, data };
+                return FixedArgSig{ type, is_array, data, resource };
             }
             }
         }
@@ -340,7 +378,9 @@ namespace winmd::reader
 
     struct CustomAttributeSig
     {
-        CustomAttributeSig(table_base const* table, byte_view& data, MethodDefSig const& ctor)
+        CustomAttributeSig(table_base const* table, byte_view& data, MethodDefSig const& ctor, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_fixed_args(resource)
+            , m_named_args(resource)
         {
             database const& db = table->get_database();
             auto const prolog = read<uint16_t>(data);
@@ -351,7 +391,7 @@ namespace winmd::reader
 
             for (auto const& param : ctor.Params())
             {
-                m_fixed_args.push_back(FixedArgSig{ db, param, data });
+                m_fixed_args.push_back(FixedArgSig{ db, param, data, resource });
             }
 
             const auto num_named_args = read<uint16_t>(data);
@@ -363,23 +403,23 @@ namespace winmd::reader
 
             for (uint16_t i = 0; i < num_named_args; ++i)
             {
-                m_named_args.emplace_back(db, data);
+                m_named_args.emplace_back(db, data, resource);
             }
         }
 
-        std::vector<FixedArgSig> const& FixedArgs() const noexcept { return m_fixed_args; }
-        std::vector<NamedArgSig> const& NamedArgs() const noexcept { return m_named_args; }
+        std::pmr::vector<FixedArgSig> const& FixedArgs() const noexcept { return m_fixed_args; }
+        std::pmr::vector<NamedArgSig> const& NamedArgs() const noexcept { return m_named_args; }
 
     private:
-        std::vector<FixedArgSig> m_fixed_args;
-        std::vector<NamedArgSig> m_named_args;
+        std::pmr::vector<FixedArgSig> m_fixed_args;
+        std::pmr::vector<NamedArgSig> m_named_args;
     };
 
-    inline auto CustomAttribute::Value() const
+    inline auto CustomAttribute::Value(std::pmr::memory_resource* resource) const
     {
         auto const ctor = Type();
-        MethodDefSig const& method_sig = ctor.type() == CustomAttributeType::MemberRef ? ctor.MemberRef().MethodSignature() : ctor.MethodDef().Signature();
+        MethodDefSig const& method_sig = ctor.type() == CustomAttributeType::MemberRef ? ctor.MemberRef().MethodSignature(resource) : ctor.MethodDef().Signature(resource);
         auto cursor = get_blob(2);
-        return CustomAttributeSig{ get_table(), cursor, method_sig };
+        return CustomAttributeSig{ get_table(), cursor, method_sig, resource };
     }
 }
@@ -21,9 +21,172 @@ namespace winmd::impl
     static_assert(bits_needed(22) == 5);
 }
 
+namespace winmd::reader
+{
+    struct database;
+}
+
+namespace winmd::impl
+{
+    // Maps the small ids stored in row handles back to their databases. An id is a slot number in its low 16 bits
+    // and the slot's generation in its high 16 bits. Slots are reused, oldest freed first, and each reuse bumps
+    // the generation, so a handle into a destroyed database resolves to nothing rather than to a row of a database
+    // opened later in the same slot. A slot whose generation would wrap is retired instead, so no id is ever
+    // issued twice. Up to 65535 databases may be open at once, and about four billion may be opened over the life
+    // of the process. Lookups take no lock: chunks of slots are only ever added, and a slot's database and id are
+    // atomic.
+    struct database_registry
+    {
+        static constexpr uint32_t slot_bits = 16;
+        static constexpr uint32_t slot_mask = (1u << slot_bits) - 1;
+        static constexpr uint32_t chunk_size = 1024;
+
+        database_registry() noexcept = default;
+        database_registry(database_registry const&) = delete;
+        database_registry& operator=(database_registry const&) = delete;
+
+        ~database_registry() noexcept
+        {
+            for (auto&& chunk : m_chunks)
+            {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        uint32_t add(reader::database const* const db)
+        {
+            std::lock_guard const lock{ m_mutex };
+            uint32_t index;
+
+            if (!m_free.empty())
+            {
+                index = m_free.front();
+                m_free.pop_front();
+            }
+            else
+            {
+                if (m_next > slot_mask)
+                {
+                    throw_invalid("Too many databases are open");
+                }
+
+                index = m_next++;
+                auto& chunk = m_chunks[index / chunk_size];
+
+                if (!chunk.load(std::memory_order_relaxed))
+                {
+                    chunk.store(new database_slot[chunk_size]{}, std::memory_order_release);
+                }
+            }
+
+            auto& slot = get_slot(index);
+            uint32_t const id = (uint32_t{ slot.generation } << slot_bits) | index;
+
+            // Stored before the id, so that a reader that sees the id also sees this database.
+            slot.db.store(db, std::memory_order_release);
+            slot.id.store(id, std::memory_order_release);
+            return id;
+        }
+
+        void remove(uint32_t const id) noexcept
+        {
+            std::lock_guard const lock{ m_mutex };
+            auto& slot = get_slot(id & slot_mask);
+            slot.id.store(0, std::memory_order_release);
+            slot.db.store(nullptr, std::memory_order_release);
+
+            if (++slot.generation != 0)
+            {
+                m_free.push_back(id & slot_mask);
+            }
+        }
+
+        reader::database const* get(uint32_t const id) const noexcept
+        {
+            auto const chunk = m_chunks[(id & slot_mask) / chunk_size].load(std::memory_order_acquire);
+
+            if (!chunk)
+            {
+                return nullptr;
+            }
+
+            // The id is read on both sides of the database, so a slot reused in between is not mistaken for ours.
+            auto const& slot = chunk[(id & slot_mask) % chunk_size];
+
+            if (slot.id.load(std::memory_order_acquire) != id)
+            {
+                return nullptr;
+            }
+
+            auto const db = slot.db.load(std::memory_order_acquire);
+            return slot.id.load(std::memory_order_acquire) == id ? db : nullptr;
+        }
+
+    private:
+
+        struct database_slot
+        {
+            std::atomic<reader::database const*> db;
+            std::atomic<uint32_t> id;
+            uint16_t generation;
+        };
+
+        database_slot& get_slot(uint32_t const index) noexcept
+        {
+            return m_chunks[index / chunk_size].load(std::memory_order_relaxed)[index % chunk_size];
+        }
+
+        std::mutex m_mutex;
+        std::array<std::atomic<database_slot*>, (slot_mask + 1) / chunk_size> m_chunks{};
+        std::deque<uint32_t> m_free;
+
+        // Slot 0 is never used, so no id is 0, which handles use for a null row.
+        uint32_t m_next{ 1 };
+    };
+
+    // Never destroyed, so that databases with static storage duration may still unregister during shutdown.
+    inline database_registry& registry = *new database_registry;
+}
+
 namespace winmd::reader
 {
     struct cache;
+    struct signature_memo;
+
+    // Identifies an attribute class within one database. Every CustomAttribute constructor (MethodDef or
+    // MemberRef) is mapped to the id of its class when the database is opened, so attribute lookups by id
+    // compare integers rather than namespace and name strings. Zero means no attribute of that class is used.
+    struct attribute_type_id
+    {
+        uint32_t value{};
+
+        explicit operator bool() const noexcept
+        {
+            return value != 0;
+        }
+
+        bool operator==(attribute_type_id const& other) const noexcept
+        {
+            return value == other.value;
+        }
+
+        bool operator!=(attribute_type_id const& other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+    // How a database guards its reads of the tables and heaps. checked bounds-checks each read as it happens.
+    // validated proves once, when the database is opened, that every heap index, table index, coded index, list
+    // range and blob length stored in the tables is in bounds, and from then on reads without checks. trusted
+    // skips both, for files from a known good tool; malformed input is then undefined behavior. Blob contents,
+    // such as signatures, are bounds-checked as they are decoded in every mode.
+    enum class open_mode
+    {
+        checked,
+        validated,
+        trusted,
+    };
 
     struct database
     {
@@ -109,14 +272,33 @@ namespace winmd::reader
             return true;
         }
 
-        explicit database(std::vector<uint8_t>&& buffer, cache const* cache = nullptr) : m_buffer{ std::move(buffer) }, m_view{ m_buffer.data(), m_buffer.data() + m_buffer.size() }, m_cache{ cache }
+        explicit database(std::vector<uint8_t>&& buffer, cache const* cache = nullptr, open_mode const mode = open_mode::checked) : m_buffer{ std::move(buffer) }, m_view{ m_buffer.data(), m_buffer.data() + m_buffer.size() }, m_cache{ cache }
+        {
+            initialize(mode);
+            m_id = impl::registry.add(this);
+        }
+
+        explicit database(std::string_view const& path, cache const* cache = nullptr, open_mode const mode = open_mode::checked) : m_view{ path }, m_path{ path }, m_cache{ cache }
         {
-            initialize();
+            std::error_code error;
+            m_write_time = std::filesystem::last_write_time(m_path, error);
+            initialize(mode);
+            m_id = impl::registry.add(this);
         }
 
-        explicit database(std::string_view const& path, cache const* cache = nullptr) : m_view{ path }, m_path{ path }, m_cache{ cache }
+        database(std::string_view const& path, open_mode const mode) : database{ path, nullptr, mode }
         {
-            initialize();
+        }
+
+        ~database() noexcept
+        {
+            impl::registry.remove(m_id);
+        }
+
+        // Identifies the database in row handles for as long as the process runs.
+        uint32_t id() const noexcept
+        {
+            return m_id;
         }
 
         table<reader::TypeRef> TypeRef{ this };
@@ -161,22 +343,86 @@ namespace winmd::reader
         template <typename T>
         table<T> const& get_table() const noexcept;
 
+        // Every table, in table id order.
+        std::array<table_base const*, 38> tables() const noexcept
+        {
+            return
+            {
+                &Module, &TypeRef, &TypeDef, &Field, &MethodDef, &Param, &InterfaceImpl, &MemberRef, &Constant,
+                &CustomAttribute, &FieldMarshal, &DeclSecurity, &ClassLayout, &FieldLayout, &StandAloneSig, &EventMap,
+                &Event, &PropertyMap, &Property, &MethodSemantics, &MethodImpl, &ModuleRef, &TypeSpec, &ImplMap,
+                &FieldRVA, &Assembly, &AssemblyProcessor, &AssemblyOS, &AssemblyRef, &AssemblyRefProcessor,
+                &AssemblyRefOS, &File, &ExportedType, &ManifestResource, &NestedClass, &GenericParam, &MethodSpec,
+                &GenericParamConstraint
+            };
+        }
+
         cache const& get_cache() const noexcept
         {
             return *m_cache;
         }
 
+        bool has_cache() const noexcept
+        {
+            return m_cache != nullptr;
+        }
+
         std::string const& path() const noexcept
         {
             return m_path;
         }
 
+        // The modification time of the file when it was opened; the default value for an in-memory database.
+        std::filesystem::file_time_type write_time() const noexcept
+        {
+            return m_write_time;
+        }
+
+        // A hash of the #GUID heap, which holds the module version id, and of the size of every heap and table.
+        // Cheap enough to compute on every open, and different for any recompiled metadata file.
+        uint64_t fingerprint() const noexcept
+        {
+            auto hash = impl::hash_string({ reinterpret_cast<char const*>(m_guids.begin()), m_guids.size() });
+
+            auto hash_size = [&](std::size_t const size)
+            {
+                auto const value = static_cast<uint64_t>(size);
+                hash = impl::hash_string({ reinterpret_cast<char const*>(&value), sizeof(value) }, hash);
+            };
+
+            hash_size(m_strings.size());
+            hash_size(m_blobs.size());
+
+            for (auto&& table : tables())
+            {
+                hash_size(table->size());
+            }
+
+            return hash;
+        }
+
+        // Whether reads of this database skip their bounds checks, because it was validated or trusted at open.
+        bool unchecked() const noexcept
+        {
+            return m_unchecked;
+        }
+
         std::string_view get_string(uint32_t const index) const
         {
+            if (auto const entry = find_string_entry(index))
+            {
+                return { reinterpret_cast<char const*>(m_strings.begin() + index), entry->length };
+            }
+
+            if (m_unchecked)
+            {
+                return reinterpret_cast<char const*>(m_strings.begin() + index);
+            }
+
             auto view = m_strings.seek(index);
-            auto last = std::find(view.begin(), view.end(), 0);
+            auto last = impl::find_terminator(view.begin(), view.end());
 
-            if (last == view.end())
+            if (!last)
             {
                 impl::throw_invalid("Missing string terminator");
             }
@@ -184,49 +430,481 @@ namespace winmd::reader
             return { reinterpret_cast<char const*>(view.begin()), static_cast<uint32_t>(last - view.begin()) };
         }
 
+        // Whether the string at index equals value. With the string table enabled, strings of another length or
+        // hash are rejected without reading the heap.
+        bool string_equals(uint32_t const index, hashed_string const& value) const
+        {
+            if (auto const entry = find_string_entry(index))
+            {
+                return entry->hash == value.hash && entry->length == value.value.size() &&
+                    impl::equal_bytes(reinterpret_cast<char const*>(m_strings.begin() + index), value.value.data(), value.value.size());
+            }
+
+            return impl::equal(get_string(index), value.value);
+        }
+
+        // Builds a side table mapping the offset of every string in the #Strings heap to its length and hash, so
+        // that get_string needs no terminator scan and string_equals can compare by hash. Offsets into the middle
+        // of a string, which the format allows but compilers rarely emit, fall back to the scan. Call before the
+        // database is shared between threads.
+        void enable_string_table();
+
+        bool string_table_enabled() const noexcept
+        {
+            return !m_string_table.empty();
+        }
+
+        // The architectures named by the type's SupportedArchitectureAttribute, or None if it has none.
+        // Computed for every TypeDef and TypeRef row when the database is opened.
+        Architecture supported_architectures(reader::TypeDef const& type) const noexcept
+        {
+            return m_type_def_arches[type.index()];
+        }
+
+        Architecture supported_architectures(reader::TypeRef const& type) const noexcept
+        {
+            return m_type_ref_arches[type.index()];
+        }
+
+        attribute_type_id find_attribute_type(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        {
+            auto const hash = qualified_name_hash(type_namespace, type_name);
+
+            for (auto type = m_attribute_types.begin() + attribute_type_position(hash); type != m_attribute_types.end() && type->hash == hash; ++type)
+            {
+                if (type->name == type_name && type->type_namespace == type_namespace)
+                {
+                    return type->id;
+                }
+            }
+
+            return {};
+        }
+
+        attribute_type_id attribute_type(reader::CustomAttribute const& attribute) const noexcept
+        {
+            auto const ctor = attribute.Type();
+
+            if (ctor.type() == CustomAttributeType::MethodDef)
+            {
+                return m_method_def_attribute_types[ctor.index()];
+            }
+
+            if (ctor.type() == CustomAttributeType::MemberRef)
+            {
+                return m_member_ref_attribute_types[ctor.index()];
+            }
+
+            return {};
+        }
+
+        // The TypeDef that cache::resolve_type_refs resolved the TypeRef to for the given architectures (None
+        // is the same as All), or nullptr if that mask has not been resolved. The TypeDef is null if the
+        // reference could not be resolved.
+        reader::TypeDef const* resolved_type_ref(reader::TypeRef const& type, Architecture const arches) const noexcept
+        {
+            auto const& resolved = m_resolved_type_refs[resolved_slot(arches)];
+            return resolved.empty() ? nullptr : &resolved[type.index()];
+        }
+
+        // The number of TypeRef rows that cache::resolve_type_refs could not resolve for the given architectures.
+        std::size_t unresolved_type_refs(Architecture const arches) const noexcept
+        {
+            return m_unresolved_type_refs[resolved_slot(arches)];
+        }
+
+        // The TypeDef in this database with the given namespace and (decorated) name, or a null TypeDef. Lets
+        // databases without a cache resolve their own types. The index it searches is built on first use.
+        reader::TypeDef find_type(std::string_view const& type_namespace, std::string_view const& type_name) const;
+
+        // The element type underlying an enum, or End if the type is not an enum. Found by a scan of the enum's
+        // fields on first use and remembered per TypeDef row, so it may be called concurrently.
+        ElementType enum_underlying_type(reader::TypeDef const& type) const;
+
+        // Enables memoized decoding through memoized_signature and memoized_value, keeping up to budget bytes of
+        // decoded signatures and attribute values. Call before the database is shared between threads.
+        void enable_memo(std::size_t const budget);
+
+        signature_memo* memo() const noexcept
+        {
+            return m_memo.get();
+        }
+
+        std::string_view type_name(reader::TypeDef const& type) const
+        {
+            return type_name(type, m_type_def_names);
+        }
+
+        std::string_view type_name(reader::TypeRef const& type) const
+        {
+            return type_name(type, m_type_ref_names);
+        }
+
+        bool type_has_name(reader::TypeDef const& type, hashed_string const& type_namespace, hashed_string const& type_name) const
+        {
+            return type_has_name(type, m_type_def_names, type_namespace, type_name);
+        }
+
+        bool type_has_name(reader::TypeRef const& type, hashed_string const& type_namespace, hashed_string const& type_name) const
+        {
+            return type_has_name(type, m_type_ref_names, type_namespace, type_name);
+        }
+
         byte_view get_blob(uint32_t const index) const
         {
+            uint32_t header{};
+            uint32_t size{};
+
+            if (m_unchecked)
+            {
+                decode_blob_header(m_blobs.begin() + index, m_blobs.end(), header, size);
+                auto const first = m_blobs.begin() + index + header;
+                return { first, first + size };
+            }
+
             auto view = m_blobs.seek(index);
-            auto initial_byte = view.as<uint8_t>();
-            uint32_t blob_size_bytes{};
 
-            switch (initial_byte >> 5)
+            if (!decode_blob_header(view.begin(), view.end(), header, size))
+            {
+                impl::throw_invalid("Invalid blob encoding");
+            }
+
+            return view.sub(header, size);
+        }
+
+    private:
+        // Reads the length prefix of the blob at first, or returns false if it is malformed or the blob extends
+        // past last.
+        static bool decode_blob_header(uint8_t const* const first, uint8_t const* const last, uint32_t& header, uint32_t& size) noexcept
+        {
+            if (first >= last)
+            {
+                return false;
+            }
+
+            switch (*first >> 5)
             {
             case 0:
             case 1:
             case 2:
             case 3:
-                blob_size_bytes = 1;
-                initial_byte &= 0x7f;
+                header = 1;
+                size = *first & 0x7f;
                 break;
 
             case 4:
             case 5:
-                blob_size_bytes = 2;
-                initial_byte &= 0x3f;
+                header = 2;
+                size = *first & 0x3f;
                 break;
 
             case 6:
-                blob_size_bytes = 4;
-                initial_byte &= 0x1f;
+                header = 4;
+                size = *first & 0x1f;
                 break;
 
             default:
-                impl::throw_invalid("Invalid blob encoding");
+                return false;
+            }
+
+            if (static_cast<std::size_t>(last - first) < header)
+            {
+                return false;
+            }
+
+            for (uint32_t byte = 1; byte < header; ++byte)
+            {
+                size = (size << 8) + first[byte];
             }
 
-            uint32_t blob_size{ initial_byte };
+            return static_cast<std::size_t>(last - first) - header >= size;
+        }
 
-            for (auto&& byte : view.sub(1, blob_size_bytes - 1))
+        static void require_in_bounds(bool const valid, char const* const what)
+        {
+            if (!valid)
             {
-                blob_size = (blob_size << 8) + byte;
+                impl::throw_invalid("Metadata ", what, " is out of bounds");
             }
+        }
 
-            return { view.sub(blob_size_bytes, blob_size) };
+        // Column widths are fixed by now, so each column is read with a plain load of its width.
+        template <typename F>
+        static void for_each_value(table_base const& rows, uint32_t const column, F const& callback)
+        {
+            rows.visit_column(column, [&](auto width)
+            {
+                for (uint32_t row = 0; row < rows.size(); ++row)
+                {
+                    callback(rows.get_fixed_value<uint32_t, width>(row, column));
+                }
+            });
         }
 
-    private:
-        void initialize()
+        // The smallest and largest value of a column, in a loop simple enough to vectorize.
+        static std::pair<uint32_t, uint32_t> column_range(table_base const& rows, uint32_t const column)
+        {
+            uint32_t low = UINT32_MAX;
+            uint32_t high = 0;
+
+            for_each_value(rows, column, [&](uint32_t const value)
+            {
+                low = std::min(low, value);
+                high = std::max(high, value);
+            });
+
+            return { low, high };
+        }
+
+        // Null is only valid where the schema allows it, such as TypeDef.Extends; elsewhere a null index would
+        // make an accessor read row -1.
+        template <typename T>
+        static void validate_coded_index(table_base const& rows, uint32_t const column, std::initializer_list<table_base const*> const targets, bool const nullable = false)
+        {
+            for_each_value(rows, column, [&](uint32_t const value)
+            {
+                if (value == 0 && nullable)
+                {
+                    return;
+                }
+
+                auto const type = value & ((1u << coded_index_bits_v<T>) - 1);
+                auto const index = value >> coded_index_bits_v<T>;
+                require_in_bounds(type < targets.size() && targets.begin()[type] && index >= 1 && index <= targets.begin()[type]->size(), "coded index");
+            });
+        }
+
+        static void validate_table_index(table_base const& rows, uint32_t const column, table_base const& target)
+        {
+            auto const[low, high] = column_range(rows, column);
+            require_in_bounds(rows.size() == 0 || (low >= 1 && high <= target.size()), "table index");
+        }
+
+        // A list runs from its row's value to the next row's, so the values must not decrease. Where rows of the
+        // target are mapped back to their owner with get_parent_row, the first list must also start at row 1.
+        static void validate_list(table_base const& rows, uint32_t const column, table_base const& target, bool const owned)
+        {
+            uint32_t previous = 1;
+
+            for_each_value(rows, column, [&](uint32_t const value)
+            {
+                require_in_bounds(value >= previous && value <= target.size() + 1, "list");
+                previous = value;
+            });
+
+            require_in_bounds(!owned || target.size() == 0 || (rows.size() > 0 && rows.get_value<uint32_t>(0, column) == 1), "list");
+        }
+
+        void validate_strings(table_base const& rows, uint32_t const column, uint32_t const strings_end) const
+        {
+            require_in_bounds(rows.size() == 0 || column_range(rows, column).second < strings_end, "string index");
+        }
+
+        void validate_blobs(table_base const& rows, uint32_t const column) const
+        {
+            for_each_value(rows, column, [&](uint32_t const index)
+            {
+                uint32_t header{};
+                uint32_t size{};
+                require_in_bounds(index < m_blobs.size() && decode_blob_header(m_blobs.begin() + index, m_blobs.end(), header, size), "blob");
+            });
+        }
+
+        void validate_guids(table_base const& rows, uint32_t const column) const
+        {
+            require_in_bounds(rows.size() == 0 || column_range(rows, column).second <= m_guids.size() / 16, "GUID index");
+        }
+
+        // The structural validation behind open_mode::validated, column by column in the order of set_columns.
+        void validate() const
+        {
+            // A string index is valid if a terminator follows it, which holds up to the last one in the heap.
+            auto const last_terminator = std::find(std::make_reverse_iterator(m_strings.end()), std::make_reverse_iterator(m_strings.begin()), 0);
+            auto const strings_end = static_cast<uint32_t>(last_terminator.base() - m_strings.begin());
+
+            std::initializer_list<table_base const*> const TypeDefOrRef{ &TypeDef, &TypeRef, &TypeSpec };
+            std::initializer_list<table_base const*> const MethodDefOrRef{ &MethodDef, &MemberRef };
+            std::initializer_list<table_base const*> const Implementation{ &File, &AssemblyRef, &ExportedType };
+
+            validate_blobs(Assembly, 3);
+            validate_strings(Assembly, 4, strings_end);
+            validate_strings(Assembly, 5, strings_end);
+            validate_blobs(AssemblyRef, 2);
+            validate_strings(AssemblyRef, 3, strings_end);
+            validate_strings(AssemblyRef, 4, strings_end);
+            validate_blobs(AssemblyRef, 5);
+            validate_table_index(AssemblyRefOS, 3, AssemblyRef);
+            validate_table_index(AssemblyRefProcessor, 1, AssemblyRef);
+            validate_table_index(ClassLayout, 2, TypeDef);
+            validate_coded_index<reader::HasConstant>(Constant, 1, { &Field, &Param, &Property });
+            validate_blobs(Constant, 2);
+            validate_coded_index<reader::HasCustomAttribute>(CustomAttribute, 0, { &MethodDef, &Field, &TypeRef, &TypeDef, &Param, &InterfaceImpl, &MemberRef, &Module, &DeclSecurity, &Property, &Event, &StandAloneSig, &ModuleRef, &TypeSpec, &Assembly, &AssemblyRef, &File, &ExportedType, &ManifestResource, &GenericParam, &GenericParamConstraint, &MethodSpec });
+            validate_coded_index<reader::CustomAttributeType>(CustomAttribute, 1, { nullptr, nullptr, &MethodDef, &MemberRef });
+            validate_blobs(CustomAttribute, 2);
+            validate_coded_index<reader::HasDeclSecurity>(DeclSecurity, 1, { &TypeDef, &MethodDef, &Assembly });
+            validate_blobs(DeclSecurity, 2);
+            validate_table_index(EventMap, 0, TypeDef);
+            validate_list(EventMap, 1, Event, true);
+            validate_strings(Event, 1, strings_end);
+            validate_coded_index<reader::TypeDefOrRef>(Event, 2, TypeDefOrRef, true);
+            validate_strings(ExportedType, 2, strings_end);
+            validate_strings(ExportedType, 3, strings_end);
+            validate_coded_index<reader::Implementation>(ExportedType, 4, Implementation);
+            validate_strings(Field, 1, strings_end);
+            validate_blobs(Field, 2);
+            validate_table_index(FieldLayout, 1, Field);
+            validate_coded_index<reader::HasFieldMarshal>(FieldMarshal, 0, { &Field, &Param });
+            validate_blobs(FieldMarshal, 1);
+            validate_table_index(FieldRVA, 1, Field);
+            validate_strings(File, 1, strings_end);
+            validate_blobs(File, 2);
+            validate_coded_index<reader::TypeOrMethodDef>(GenericParam, 2, { &TypeDef, &MethodDef });
+            validate_strings(GenericParam, 3, strings_end);
+            validate_table_index(GenericParamConstraint, 0, GenericParam);
+            validate_coded_index<reader::TypeDefOrRef>(GenericParamConstraint, 1, TypeDefOrRef);
+            validate_coded_index<reader::MemberForwarded>(ImplMap, 1, { &Field, &MethodDef });
+            validate_strings(ImplMap, 2, strings_end);
+            validate_table_index(ImplMap, 3, ModuleRef);
+            validate_table_index(InterfaceImpl, 0, TypeDef);
+            validate_coded_index<reader::TypeDefOrRef>(InterfaceImpl, 1, TypeDefOrRef);
+            validate_strings(ManifestResource, 2, strings_end);
+            validate_coded_index<reader::Implementation>(ManifestResource, 3, Implementation, true);
+            validate_coded_index<reader::MemberRefParent>(MemberRef, 0, { &TypeDef, &TypeRef, &ModuleRef, &MethodDef, &TypeSpec });
+            validate_strings(MemberRef, 1, strings_end);
+            validate_blobs(MemberRef, 2);
+            validate_strings(MethodDef, 3, strings_end);
+            validate_blobs(MethodDef, 4);
+            validate_list(MethodDef, 5, Param, false);
+            validate_table_index(MethodImpl, 0, TypeDef);
+            validate_coded_index<reader::MethodDefOrRef>(MethodImpl, 1, MethodDefOrRef);
+            validate_coded_index<reader::MethodDefOrRef>(MethodImpl, 2, MethodDefOrRef);
+            validate_table_index(MethodSemantics, 1, MethodDef);
+            validate_coded_index<reader::HasSemantics>(MethodSemantics, 2, { &Event, &Property });
+            validate_coded_index<reader::MethodDefOrRef>(MethodSpec, 0, MethodDefOrRef);
+            validate_blobs(MethodSpec, 1);
+            validate_strings(Module, 1, strings_end);
+            validate_guids(Module, 2);
+            validate_guids(Module, 3);
+            validate_guids(Module, 4);
+            validate_strings(ModuleRef, 0, strings_end);
+            validate_table_index(NestedClass, 0, TypeDef);
+            validate_table_index(NestedClass, 1, TypeDef);
+            validate_strings(Param, 2, strings_end);
+            validate_strings(Property, 1, strings_end);
+            validate_blobs(Property, 2);
+            validate_table_index(PropertyMap, 0, TypeDef);
+            validate_list(PropertyMap, 1, Property, true);
+            validate_blobs(StandAloneSig, 0);
+            validate_strings(TypeDef, 1, strings_end);
+            validate_strings(TypeDef, 2, strings_end);
+            validate_coded_index<reader::TypeDefOrRef>(TypeDef, 3, TypeDefOrRef, true);
+            validate_list(TypeDef, 4, Field, true);
+            validate_list(TypeDef, 5, MethodDef, true);
+            validate_coded_index<reader::ResolutionScope>(TypeRef, 0, { &Module, &ModuleRef, &AssemblyRef, &TypeRef }, true);
+            validate_strings(TypeRef, 1, strings_end);
+            validate_strings(TypeRef, 2, strings_end);
+            validate_blobs(TypeSpec, 0);
+        }
+
+        template <typename T>
+        std::string_view type_name(T const& type, std::vector<std::string_view> const& names) const
+        {
+            if (!names.empty() && !names[type.index()].empty())
+            {
+                return names[type.index()];
+            }
+
+            return type.TypeDisplayName();
+        }
+
+        template <typename T>
+        bool type_has_name(T const& type, std::vector<std::string_view> const& names, hashed_string const& type_namespace, hashed_string const& type_name) const
+        {
+            if (!names.empty() && !names[type.index()].empty())
+            {
+                if (names[type.index()] != type_name.value)
+                {
+                    return false;
+                }
+            }
+            else if (!string_equals(type.template get_value<uint32_t>(1), type_name))
+            {
+                return false;
+            }
+
+            return string_equals(type.template get_value<uint32_t>(2), type_namespace);
+        }
+
+        struct string_entry
+        {
+            uint32_t offset;
+            uint32_t length;
+            uint64_t hash;
+        };
+
+        static constexpr uint32_t empty_string_entry{ UINT32_MAX };
+
+        // Open addressing with linear probing, keyed by heap offset.
+        string_entry const* find_string_entry(uint32_t const index) const noexcept
+        {
+            if (m_string_table.empty())
+            {
+                return nullptr;
+            }
+
+            auto const mask = m_string_table.size() - 1;
+
+            for (auto position = string_slot(index);; position = (position + 1) & mask)
+            {
+                auto const& entry = m_string_table[position];
+
+                if (entry.offset == index)
+                {
+                    return &entry;
+                }
+
+                if (entry.offset == empty_string_entry)
+                {
+                    return nullptr;
+                }
+            }
+        }
+
+        std::size_t string_slot(uint32_t const index) const noexcept
+        {
+            return static_cast<std::size_t>((index * 0x9e3779b97f4a7c15) >> m_string_shift);
+        }
+
+        // Builds the decorated name (Name@X86) of every row with a SupportedArchitectureAttribute, so that TypeName
+        // reads immutable state only. Other rows' names are their TypeDisplayName and need no storage.
+        template <typename T>
+        void initialize_type_names(table<T> const& rows, std::vector<Architecture> const& arches, std::vector<std::string_view>& names)
+        {
+            for (auto&& type : rows)
+            {
+                if (arches[type.index()] == Architecture::None)
+                {
+                    continue;
+                }
+
+                if (names.empty())
+                {
+                    names.resize(rows.size());
+                }
+
+                std::string_view const display_name = type.TypeDisplayName();
+                auto const suffix = ArchesToName(arches[type.index()]);
+                auto const size = display_name.size() + 1 + suffix.size();
+                auto const data = static_cast<char*>(m_names.allocate(size + 1, 1));
+                std::copy(display_name.begin(), display_name.end(), data);
+                data[display_name.size()] = '@';
+                std::copy(suffix.begin(), suffix.end(), data + display_name.size() + 1);
+                data[size] = 0;
+                names[type.index()] = { data, size };
+            }
+        }
+
+        void initialize(open_mode const mode)
         {
             auto dos = m_view.as<impl::image_dos_header>();
 
@@ -479,6 +1157,235 @@ namespace winmd::reader
             GenericParam.set_data(view);
             MethodSpec.set_data(view);
             GenericParamConstraint.set_data(view);
+
+            if (mode == open_mode::validated)
+            {
+                validate();
+            }
+
+            if (mode != open_mode::checked)
+            {
+                m_unchecked = true;
+
+                for (auto&& table : this->tables())
+                {
+                    const_cast<table_base*>(table)->m_checked = false;
+                }
+            }
+
+            initialize_architectures();
+            initialize_type_names(TypeDef, m_type_def_arches, m_type_def_names);
+            initialize_type_names(TypeRef, m_type_ref_arches, m_type_ref_names);
+            initialize_attribute_types();
+            std::vector<std::atomic<ElementType>>(TypeDef.size()).swap(m_enum_types);
+        }
+
+        static uint64_t qualified_name_hash(std::string_view const& type_namespace, std::string_view const& type_name) noexcept
+        {
+            return impl::hash_string(type_name, impl::hash_string("\0"sv, impl::hash_string(type_namespace)));
+        }
+
+        attribute_type_id intern_attribute_type(std::string_view const& type_namespace, std::string_view const& type_name)
+        {
+            if (auto const id = find_attribute_type(type_namespace, type_name))
+            {
+                return id;
+            }
+
+            auto const hash = qualified_name_hash(type_namespace, type_name);
+            attribute_type_id const id{ static_cast<uint32_t>(m_attribute_types.size() + 1) };
+            m_attribute_types.insert(m_attribute_types.begin() + attribute_type_position(hash), { hash, type_namespace, type_name, id });
+            return id;
+        }
+
+        // m_attribute_types is kept sorted by hash, so lookups are a binary search. Returns the offset of the
+        // first entry with the hash, or of where one would be inserted.
+        std::size_t attribute_type_position(uint64_t const hash) const noexcept
+        {
+            return std::lower_bound(m_attribute_types.begin(), m_attribute_types.end(), hash, [](auto&& type, uint64_t const hash)
+            {
+                return type.hash < hash;
+            }) - m_attribute_types.begin();
+        }
+
+        // Maps the constructor of every CustomAttribute row to the interned id of its attribute class.
+        void initialize_attribute_types()
+        {
+            m_method_def_attribute_types.assign(MethodDef.size(), {});
+            m_member_ref_attribute_types.assign(MemberRef.size(), {});
+            std::vector<bool> method_defs(MethodDef.size());
+            bool has_method_defs{};
+
+            for (auto&& attribute : CustomAttribute)
+            {
+                auto const ctor = attribute.Type();
+
+                // attribute_type indexes these vectors without checks, so every constructor is checked here.
+                if (ctor.type() == CustomAttributeType::MethodDef)
+                {
+                    check_row(ctor.index(), method_defs.size());
+                    method_defs[ctor.index()] = true;
+                    has_method_defs = true;
+                    continue;
+                }
+
+                if (ctor.type() != CustomAttributeType::MemberRef)
+                {
+                    continue;
+                }
+
+                check_row(ctor.index(), m_member_ref_attribute_types.size());
+
+                if (m_member_ref_attribute_types[ctor.index()])
+                {
+                    continue;
+                }
+
+                auto const parent = MemberRef[ctor.index()].Class();
+
+                if (parent.type() == MemberRefParent::TypeRef)
+                {
+                    auto const type = TypeRef[parent.index()];
+                    m_member_ref_attribute_types[ctor.index()] = intern_attribute_type(type.TypeNamespace(), type.TypeName());
+                }
+                else if (parent.type() == MemberRefParent::TypeDef)
+                {
+                    auto const type = TypeDef[parent.index()];
+                    m_member_ref_attribute_types[ctor.index()] = intern_attribute_type(type.TypeNamespace(), type.TypeName());
+                }
+            }
+
+            if (!has_method_defs)
+            {
+                return;
+            }
+
+            for (auto&& type : TypeDef)
+            {
+                auto const [first, last] = method_range(type);
+
+                for (auto method = first; method < last; ++method)
+                {
+                    if (method_defs[method])
+                    {
+                        m_method_def_attribute_types[method] = intern_attribute_type(type.TypeNamespace(), type.TypeName());
+                    }
+                }
+            }
+        }
+
+        // The MethodDef rows [first, last) in a TypeDef's method list. The scans at open run in every mode and
+        // index plain vectors, so the range is checked here rather than by the table.
+        std::pair<uint32_t, uint32_t> method_range(reader::TypeDef const& type) const
+        {
+            auto const first = type.get_value<uint32_t>(5) - 1;
+            auto const last = type.index() + 1 < TypeDef.size() ? TypeDef[type.index() + 1].get_value<uint32_t>(5) - 1 : MethodDef.size();
+
+            if (first > last || last > MethodDef.size())
+            {
+                impl::throw_invalid("Invalid MethodList range");
+            }
+
+            return { first, last };
+        }
+
+        static void check_row(uint32_t const row, std::size_t const size)
+        {
+            if (row >= size)
+            {
+                impl::throw_invalid("Invalid row index");
+            }
+        }
+
+        // A single pass over the CustomAttribute table that records the SupportedArchitectureAttribute value of
+        // every TypeDef and TypeRef, so that architecture queries and decorated names need no attribute scans.
+        void initialize_architectures()
+        {
+            m_type_def_arches.assign(TypeDef.size(), Architecture::None);
+            m_type_ref_arches.assign(TypeRef.size(), Architecture::None);
+
+            auto is_attribute = [](auto&& type)
+            {
+                return type.TypeDisplayName() == "SupportedArchitectureAttribute"sv && type.TypeNamespace() == "Windows.Win32.Foundation.Metadata"sv;
+            };
+
+            std::vector<bool> method_defs(MethodDef.size());
+            std::vector<bool> member_refs(MemberRef.size());
+            bool found{};
+
+            for (auto&& type : TypeDef)
+            {
+                if (is_attribute(type))
+                {
+                    auto const [first, last] = method_range(type);
+                    std::fill(method_defs.begin() + first, method_defs.begin() + last, true);
+                    found = true;
+                }
+            }
+
+            for (auto&& member : MemberRef)
+            {
+                auto const parent = member.Class();
+
+                if ((parent.type() == MemberRefParent::TypeRef && is_attribute(TypeRef[parent.index()])) ||
+                    (parent.type() == MemberRefParent::TypeDef && is_attribute(TypeDef[parent.index()])))
+                {
+                    member_refs[member.index()] = true;
+                    found = true;
+                }
+            }
+
+            if (!found)
+            {
+                return;
+            }
+
+            for (auto&& attribute : CustomAttribute)
+            {
+                auto const ctor = attribute.Type();
+
+                if (ctor.type() == CustomAttributeType::MethodDef)
+                {
+                    check_row(ctor.index(), method_defs.size());
+                }
+                else if (ctor.type() == CustomAttributeType::MemberRef)
+                {
+                    check_row(ctor.index(), member_refs.size());
+                }
+
+                if (!(ctor.type() == CustomAttributeType::MethodDef && method_defs[ctor.index()]) &&
+                    !(ctor.type() == CustomAttributeType::MemberRef && member_refs[ctor.index()]))
+                {
+                    continue;
+                }
+
+                auto const parent = attribute.Parent();
+                std::vector<Architecture>* arches{};
+
+                if (parent.type() == HasCustomAttribute::TypeDef)
+                {
+                    arches = &m_type_def_arches;
+                }
+                else if (parent.type() == HasCustomAttribute::TypeRef)
+                {
+                    arches = &m_type_ref_arches;
+                }
+                else
+                {
+                    continue;
+                }
+
+                // The only fixed argument is the Architecture enum, stored as an int32 after the prolog.
+                auto cursor = get_blob(attribute.get_value<uint32_t>(2));
+
+                if (read<uint16_t>(cursor) != 0x0001)
+                {
+                    impl::throw_invalid("CustomAttribute blobs must start with prolog of 0x0001");
+                }
+
+                check_row(parent.index(), arches->size());
+                (*arches)[parent.index()] = static_cast<Architecture>(read<int32_t>(cursor));
+            }
         }
 
         struct stream_range
@@ -510,6 +1417,21 @@ namespace winmd::reader
             return static_cast<uint32_t>(8 + name.size() + padding);
         }
 
+        friend struct cache;
+
+        static std::size_t resolved_slot(Architecture const arches) noexcept
+        {
+            return arches == Architecture::None ? Architecture::All : arches & Architecture::All;
+        }
+
+        std::size_t set_resolved_type_refs(Architecture const arches, std::vector<reader::TypeDef>&& types) noexcept
+        {
+            auto const slot = resolved_slot(arches);
+            m_unresolved_type_refs[slot] = std::count(types.begin(), types.end(), reader::TypeDef{});
+            m_resolved_type_refs[slot] = std::move(types);
+            return m_unresolved_type_refs[slot];
+        }
+
         static impl::image_section_header const* section_from_rva(impl::image_section_header const* const first, impl::image_section_header const* const last, uint32_t const rva) noexcept
         {
             return std::find_if(first, last, [rva](auto&& section) noexcept
@@ -527,12 +1449,134 @@ namespace winmd::reader
         file_view m_view;
 
         std::string const m_path;
+        std::filesystem::file_time_type m_write_time{};
+        bool m_unchecked{};
         byte_view m_strings;
+        std::vector<string_entry> m_string_table;
+        uint32_t m_string_shift{};
         byte_view m_blobs;
         byte_view m_guids;
         cache const* m_cache;
+        uint32_t m_id{};
+
+        std::vector<Architecture> m_type_def_arches;
+        std::vector<Architecture> m_type_ref_arches;
+
+        struct interned_attribute_type
+        {
+            uint64_t hash;
+            std::string_view type_namespace;
+            std::string_view name;
+            attribute_type_id id;
+        };
+
+        // Indexed by architecture mask, then by TypeRef row. Empty until cache::resolve_type_refs fills them.
+        std::array<std::vector<reader::TypeDef>, Architecture::All + 1> m_resolved_type_refs;
+        std::array<std::size_t, Architecture::All + 1> m_unresolved_type_refs{};
+
+        std::vector<interned_attribute_type> m_attribute_types;
+        std::shared_ptr<signature_memo> m_memo;
+        std::vector<attribute_type_id> m_method_def_attribute_types;
+        std::vector<attribute_type_id> m_member_ref_attribute_types;
+
+        // Decorated type names, per row; empty unless some row has a SupportedArchitectureAttribute.
+        std::vector<std::string_view> m_type_def_names;
+        std::vector<std::string_view> m_type_ref_names;
+        std::pmr::monotonic_buffer_resource m_names;
+
+        // Per TypeDef row; End until enum_underlying_type first looks at the row.
+        mutable std::vector<std::atomic<ElementType>> m_enum_types;
+
+        // TypeDef rows sorted by the hash of their namespace and name, for find_type.
+        mutable std::vector<std::pair<uint64_t, uint32_t>> m_type_index;
+        mutable std::once_flag m_type_index_once;
     };
 
+    template <typename T>
+    inline std::string_view TypeBase<T>::TypeName() const
+    {
+        auto const& row = static_cast<T const&>(*this);
+        return row.get_database().type_name(row);
+    }
+
+    template <typename T>
+    inline bool TypeBase<T>::has_name(hashed_string const& type_namespace, hashed_string const& type_name) const
+    {
+        auto const& row = static_cast<T const&>(*this);
+        return row.get_database().type_has_name(row, type_namespace, type_name);
+    }
+
+    inline void database::enable_string_table()
+    {
+        std::vector<uint32_t> terminators;
+        impl::find_zero_bytes(m_strings.begin(), m_strings.end(), terminators);
+        std::vector<string_entry> entries;
+        entries.reserve(terminators.size());
+        uint32_t start{};
+
+        for (auto terminator : terminators)
+        {
+            std::string_view const value{ reinterpret_cast<char const*>(m_strings.begin() + start), terminator - start };
+            entries.push_back({ start, static_cast<uint32_t>(value.size()), impl::hash_string(value) });
+            start = terminator + 1;
+        }
+
+        uint32_t bits = 1;
+
+        while ((std::size_t{ 1 } << bits) < entries.size() * 2)
+        {
+            ++bits;
+        }
+
+        std::vector<string_entry> table(std::size_t{ 1 } << bits, string_entry{ empty_string_entry, 0, 0 });
+        m_string_shift = 64 - bits;
+        auto const mask = table.size() - 1;
+
+        for (auto&& entry : entries)
+        {
+            auto position = static_cast<std::size_t>((entry.offset * 0x9e3779b97f4a7c15) >> m_string_shift);
+
+            while (table[position].offset != empty_string_entry)
+            {
+                position = (position + 1) & mask;
+            }
+
+            table[position] = entry;
+        }
+
+        m_string_table = std::move(table);
+    }
+
+    inline reader::TypeDef database::find_type(std::string_view const& type_namespace, std::string_view const& type_name) const
+    {
+        std::call_once(m_type_index_once, [&]
+        {
+            m_type_index.reserve(TypeDef.size());
+
+            for (auto&& type : TypeDef)
+            {
+                m_type_index.emplace_back(qualified_name_hash(type.TypeNamespace(), type.TypeName()), type.index());
+            }
+
+            std::sort(m_type_index.begin(), m_type_index.end());
+        });
+
+        auto const hash = qualified_name_hash(type_namespace, type_name);
+        auto entry = std::lower_bound(m_type_index.begin(), m_type_index.end(), std::pair{ hash, uint32_t{} });
+
+        for (; entry != m_type_index.end() && entry->first == hash; ++entry)
+        {
+            auto const type = TypeDef[entry->second];
+
+            if (type.TypeName() == type_name && type.TypeNamespace() == type_namespace)
+            {
+                return type;
+            }
+        }
+
+        return {};
+    }
+
     template <typename Row>
     inline byte_view row_base<Row>::get_blob(uint32_t const column) const
     {
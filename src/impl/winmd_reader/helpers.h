@@ -13,49 +13,109 @@ namespace winmd::reader
         return range.second - range.first;
     }
 
-    inline auto find(TypeRef const& type, Architecture arches)
+    inline TypeDef find(TypeRef const& type, Architecture arches)
     {
+        if (auto const resolved = type.get_database().resolved_type_ref(type, arches))
+        {
+            return *resolved;
+        }
+
         if (type.ResolutionScope().type() != ResolutionScope::TypeRef)
         {
             return type.get_database().get_cache().find(type.TypeNamespace(), type.TypeName());
         }
         else
         {
-            auto enclosing_type = find(type.ResolutionScope().TypeRef(), arches);
+            auto const& scope = type.ResolutionScope().TypeRef();
+            TypeDef enclosing_type;
+
+            // Architecture variants are top-level types, so the architectures only select the outermost type.
+            if (scope.ResolutionScope().type() != ResolutionScope::TypeRef)
+            {
+                auto const& cache = type.get_database().get_cache();
+                enclosing_type = cache.find(scope.TypeNamespace(), scope.TypeName(), arches);
+
+                if (!enclosing_type)
+                {
+                    enclosing_type = cache.find(scope.TypeNamespace(), scope.TypeName());
+                }
+            }
+            else
+            {
+                enclosing_type = find(scope, arches);
+            }
+
             if (!enclosing_type)
             {
                 return TypeDef{};
             }
-			if (arches == Architecture::None)
-			{
-				arches = Architecture::All;
-			}
-			auto pType = &enclosing_type;
-			do
-			{
-				Architecture pType_arches = GetSupportedArchitectures(*pType);
-				if (pType_arches == Architecture::None)
-				{
-					pType_arches = Architecture::All;
-				}
-				if (pType_arches & arches)
-				{
-					enclosing_type = *pType;
-					break;
-				}
-			} while (pType = pType->next);
-            auto const& nested_types = enclosing_type.get_cache().nested_types(enclosing_type);
-            auto iter = std::find_if(nested_types.begin(), nested_types.end(),
-                [name = type.TypeName()](TypeDef const& arg)
+
+            return enclosing_type.get_cache().find_nested(enclosing_type, type.TypeName());
+        }
+    }
+
+    inline std::size_t cache::resolve_type_refs(Architecture arches)
+    {
+        if (arches == Architecture::None)
+        {
+            arches = Architecture::All;
+        }
+
+        m_resolved_arches |= 1u << arches;
+
+        // Drop earlier results first so that find() below resolves from scratch.
+        for (auto&& db : m_databases)
+        {
+            db.set_resolved_type_refs(arches, {});
+        }
+
+        std::size_t unresolved{};
+
+        for (auto&& db : m_databases)
+        {
+            std::vector<TypeDef> types;
+            types.reserve(db.TypeRef.size());
+
+            for (auto&& type : db.TypeRef)
             {
-                return name == arg.TypeName();
-            });
-            if (iter == nested_types.end())
+                types.push_back(reader::find(type, arches));
+            }
+
+            unresolved += db.set_resolved_type_refs(arches, std::move(types));
+        }
+
+        return unresolved;
+    }
+
+    // Calls callback(namespace_name, members) for every namespace of the cache that the filter includes, on up to
+    // concurrency worker threads (0 picks the hardware concurrency), balanced by the number of types in each
+    // namespace. The first exception thrown by a callback is rethrown once every worker has finished.
+    //
+    // While the workers run, the cache, its databases and the filter may be shared read-only: find, find_nested,
+    // nested_types, namespaces(), the category lists (which classify a lazily classified namespace under a lock on
+    // first use), TypeName and other row accessors, signature and attribute decoding, and the signature memo are
+    // all safe to call concurrently, as is notify_file_changed. add_database, remove_database, replace_database,
+    // reload_changed_databases, remove_type, enable_memo, enable_string_tables and resolve_type_refs are not, and
+    // must not be called until for_each_namespace_parallel returns.
+    template <typename F>
+    void for_each_namespace_parallel(cache const& cache, filter const& filter, F const& callback, uint32_t const concurrency = 0)
+    {
+        std::vector<std::pair<std::string_view const, cache::namespace_members> const*> namespaces;
+        std::vector<std::size_t> weights;
+
+        for (auto&& ns : cache.namespaces())
+        {
+            if (filter.includes(ns.second))
             {
-                return TypeDef{};
+                namespaces.push_back(&ns);
+                weights.push_back(ns.second.types.size());
             }
-            return *iter;
         }
+
+        impl::parallel_for_weighted(weights, concurrency, [&](std::size_t const index)
+        {
+            callback(namespaces[index]->first, namespaces[index]->second);
+        });
     }
 
     inline auto find_required(TypeRef const& type)
@@ -67,17 +127,12 @@ namespace winmd::reader
         else
         {
             auto enclosing_type = find_required(type.ResolutionScope().TypeRef());
-            auto const& nested_types = enclosing_type.get_cache().nested_types(enclosing_type);
-            auto iter = std::find_if(nested_types.begin(), nested_types.end(),
-                [name = type.TypeName()](TypeDef const& arg)
-            {
-                return name == arg.TypeName();
-            });
-            if (iter == nested_types.end())
+            auto const nested_type = enclosing_type.get_cache().find_nested(enclosing_type, type.TypeName());
+            if (!nested_type)
             {
                 impl::throw_invalid("Type '", enclosing_type.TypeName(), ".", type.TypeName(), "' could not be found");
             }
-            return *iter;
+            return nested_type;
         }
     }
 
@@ -117,9 +172,12 @@ namespace winmd::reader
 
     inline bool is_const(ParamSig const& param)
     {
+        static constexpr hashed_string is_const_namespace{ "System.Runtime.CompilerServices"sv };
+        static constexpr hashed_string is_const_name{ "IsConst"sv };
+
         auto is_type_const = [](auto&& type)
         {
-            return type.TypeNamespace() == "System.Runtime.CompilerServices" && type.TypeName() == "IsConst";
+            return type.has_name(is_const_namespace, is_const_name);
         };
 
         for (auto const& cmod : param.CustomMod())
@@ -148,17 +206,26 @@ namespace winmd::reader
 	template<class T>
 	Architecture GetSupportedArchitectures(const T& type)
 	{
-		Architecture arches = Architecture::None;
-		auto const attr = get_attribute(type, "Windows.Win32.Foundation.Metadata", "SupportedArchitectureAttribute");
-		if (attr)
+		if constexpr (std::is_same_v<T, TypeDef> || std::is_same_v<T, TypeRef>)
 		{
-			CustomAttributeSig attr_sig = attr.Value();
-			FixedArgSig fixed_arg = attr_sig.FixedArgs()[0];
-			ElemSig elem_sig = std::get<ElemSig>(fixed_arg.value);
-			ElemSig::EnumValue enum_value = std::get<ElemSig::EnumValue>(elem_sig.value);
-			auto const arch_flags = std::get<int32_t>(enum_value.value);
-			arches = (Architecture)arch_flags;
+			return type.get_database().supported_architectures(type);
+		}
+		else
+		{
+			Architecture arches = Architecture::None;
+			auto const attr = get_attribute(type, "Windows.Win32.Foundation.Metadata", "SupportedArchitectureAttribute");
+			if (attr)
+			{
+				// The only fixed argument is the Architecture enum, so read its int32 straight from the blob rather than
+				// decoding a CustomAttributeSig, which would need the cache to resolve the enum type.
+				auto cursor = attr.get_database().get_blob(attr.template get_value<uint32_t>(2));
+				if (read<uint16_t>(cursor) != 0x0001)
+				{
+					impl::throw_invalid("CustomAttribute blobs must start with prolog of 0x0001");
+				}
+				arches = static_cast<Architecture>(read<int32_t>(cursor));
+			}
+			return arches;
 		}
-		return arches;
 	}
 }
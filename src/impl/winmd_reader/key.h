@@ -119,21 +119,43 @@ namespace winmd::reader
         return extends_type(*this, "System"sv, "Enum"sv);
     }
 
+    inline ElementType database::enum_underlying_type(reader::TypeDef const& type) const
+    {
+        auto& slot = m_enum_types[type.index()];
+        auto underlying_type = slot.load(std::memory_order_relaxed);
+
+        if (underlying_type != ElementType::End || !type.is_enum())
+        {
+            return underlying_type;
+        }
+
+        for (auto field : type.FieldList())
+        {
+            if (!field.Flags().Literal() && !field.Flags().Static())
+            {
+                XLANG_ASSERT(underlying_type == ElementType::End);
+                underlying_type = std::get<ElementType>(field.Signature().Type().Type());
+                XLANG_ASSERT(ElementType::Boolean <= underlying_type && underlying_type <= ElementType::U8);
+            }
+        }
+
+        // Racing readers compute the same value, so a relaxed store is enough.
+        slot.store(underlying_type, std::memory_order_relaxed);
+        return underlying_type;
+    }
+
     struct EnumDefinition
     {
         explicit EnumDefinition(TypeDef const& type)
+            : EnumDefinition(type, type.get_database().enum_underlying_type(type))
+        {
+        }
+
+        EnumDefinition(TypeDef const& type, ElementType const underlying_type)
             : m_typedef(type)
+            , m_underlying_type(underlying_type)
         {
             XLANG_ASSERT(type.is_enum());
-            for (auto field : type.FieldList())
-            {
-                if (!field.Flags().Literal() && !field.Flags().Static())
-                {
-                    XLANG_ASSERT(m_underlying_type == ElementType::End);
-                    m_underlying_type = std::get<ElementType>(field.Signature().Type().Type());
-                    XLANG_ASSERT(ElementType::Boolean <= m_underlying_type && m_underlying_type <= ElementType::U8);
-                }
-            }
         }
 
         auto get_enumerator(std::string_view const& name) const
@@ -159,14 +181,20 @@ namespace winmd::reader
         return EnumDefinition{ *this };
     }
 
+    // The id must come from the row's database, e.g. row.get_database().find_attribute_type(...).
     template <typename T>
-    CustomAttribute get_attribute(T const& row, std::string_view const& type_namespace, std::string_view const& type_name)
+    CustomAttribute get_attribute(T const& row, attribute_type_id const& type)
     {
-        for (auto&& attribute : row.CustomAttribute())
+        if (!type)
         {
-            auto pair = attribute.TypeNamespaceAndName();
+            return {};
+        }
+
+        auto const& db = row.get_database();
 
-            if (pair.first == type_namespace && pair.second == type_name)
+        for (auto&& attribute : row.CustomAttribute())
+        {
+            if (db.attribute_type(attribute) == type)
             {
                 return attribute;
             }
@@ -175,6 +203,24 @@ namespace winmd::reader
         return {};
     }
 
+    template <typename T>
+    bool has_attribute(T const& row, attribute_type_id const& type)
+    {
+        return static_cast<bool>(get_attribute(row, type));
+    }
+
+    template <typename T>
+    CustomAttribute get_attribute(T const& row, std::string_view const& type_namespace, std::string_view const& type_name)
+    {
+        return get_attribute(row, row.get_database().find_attribute_type(type_namespace, type_name));
+    }
+
+    template <typename T>
+    bool has_attribute(T const& row, std::string_view const& type_namespace, std::string_view const& type_name)
+    {
+        return static_cast<bool>(get_attribute(row, type_namespace, type_name));
+    }
+
     enum class category
     {
         interface_type,
@@ -0,0 +1,269 @@
+
+namespace winmd::reader
+{
+    // An optional, per-database memo of decoded method signatures and custom attribute values. Each blob is
+    // decoded at most once while it stays in the memo. Entries are keyed by blob offset, charged for the memory
+    // their decoded tree allocates and evicted least recently used first once the budget is exceeded. Results
+    // are shared, so an entry remains valid for as long as a caller holds it even after eviction. All members
+    // may be called concurrently: entries are spread over independently locked shards, each with its own LRU
+    // order, so readers decoding different blobs rarely contend. The budget is shared by all shards; an insert
+    // that exceeds it evicts from its own shard first and then from the others. A result larger than the whole
+    // budget is returned without being kept.
+    struct signature_memo
+    {
+        struct statistics
+        {
+            uint64_t hits{};
+            uint64_t misses{};
+            uint64_t evictions{};
+            std::size_t bytes{};
+            std::size_t entries{};
+        };
+
+        explicit signature_memo(std::size_t const budget) noexcept : m_budget(budget)
+        {
+        }
+
+        signature_memo(signature_memo const&) = delete;
+        signature_memo& operator=(signature_memo const&) = delete;
+
+        std::shared_ptr<MethodDefSig const> signature(MethodDef const& method)
+        {
+            return lookup<MethodDefSig>(method.get_value<uint32_t>(4), [&](std::pmr::memory_resource* resource)
+            {
+                return method.Signature(resource);
+            });
+        }
+
+        std::shared_ptr<MethodDefSig const> signature(MemberRef const& member)
+        {
+            return lookup<MethodDefSig>(member.get_value<uint32_t>(2), [&](std::pmr::memory_resource* resource)
+            {
+                return member.MethodSignature(resource);
+            });
+        }
+
+        std::shared_ptr<CustomAttributeSig const> value(CustomAttribute const& attribute)
+        {
+            // The same blob may be decoded differently for different constructors, so both form the key.
+            uint64_t const key = (static_cast<uint64_t>(attribute.get_value<uint32_t>(1)) << 32) | attribute.get_value<uint32_t>(2);
+
+            return lookup<CustomAttributeSig>(key, [&](std::pmr::memory_resource* resource)
+            {
+                auto const ctor = attribute.Type();
+                auto const ctor_signature = ctor.type() == CustomAttributeType::MemberRef ? signature(ctor.MemberRef()) : signature(ctor.MethodDef());
+                auto const& db = attribute.get_database();
+                auto cursor = db.get_blob(attribute.get_value<uint32_t>(2));
+                return CustomAttributeSig{ &db.CustomAttribute, cursor, *ctor_signature, resource };
+            });
+        }
+
+        statistics get_statistics() const
+        {
+            statistics result;
+
+            for (auto&& shard : m_shards)
+            {
+                std::lock_guard const guard(shard.lock);
+                result.hits += shard.counts.hits;
+                result.misses += shard.counts.misses;
+                result.evictions += shard.counts.evictions;
+                result.bytes += shard.counts.bytes;
+                result.entries += shard.entries.size();
+            }
+
+            return result;
+        }
+
+        void clear()
+        {
+            for (auto&& shard : m_shards)
+            {
+                std::lock_guard const guard(shard.lock);
+                shard.entries.clear();
+                shard.order.clear();
+                m_bytes -= shard.counts.bytes;
+                shard.counts.bytes = 0;
+            }
+        }
+
+    private:
+
+        // Counts what a decode allocates so that each entry can be charged for its actual size.
+        struct counting_resource final : std::pmr::memory_resource
+        {
+            std::size_t allocated{};
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override
+            {
+                allocated += bytes;
+                return m_upstream->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+            {
+                m_upstream->deallocate(pointer, bytes, alignment);
+            }
+
+            bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+            {
+                return this == &other;
+            }
+
+            std::pmr::memory_resource* const m_upstream{ std::pmr::get_default_resource() };
+        };
+
+        template <typename T>
+        struct entry
+        {
+            counting_resource resource;
+            std::optional<T> value;
+        };
+
+        struct node
+        {
+            std::shared_ptr<void const> value;
+            std::size_t size;
+            std::list<uint64_t>::iterator position;
+        };
+
+        struct shard
+        {
+            mutable std::mutex lock;
+            std::unordered_map<uint64_t, node> entries;
+            std::list<uint64_t> order;
+            statistics counts;
+        };
+
+        static constexpr uint32_t shard_bits = 4;
+        static constexpr std::size_t shard_count = std::size_t{ 1 } << shard_bits;
+
+        static std::size_t shard_index(uint64_t const key) noexcept
+        {
+            // Blob offsets are clustered, so mix the key before taking its top bits.
+            return (key * 0x9e3779b97f4a7c15ull) >> (64 - shard_bits);
+        }
+
+        // Evicts least recently used entries from the shard while the memo is over budget, stopping short of the
+        // entry keyed by keep. The caller holds the shard's lock.
+        void evict(shard& shard, std::optional<uint64_t> const keep)
+        {
+            while (m_bytes.load(std::memory_order_relaxed) > m_budget && !shard.order.empty() && shard.order.back() != keep)
+            {
+                auto const last = shard.entries.find(shard.order.back());
+                shard.counts.bytes -= last->second.size;
+                m_bytes -= last->second.size;
+                ++shard.counts.evictions;
+                shard.entries.erase(last);
+                shard.order.pop_back();
+            }
+        }
+
+        template <typename T, typename F>
+        std::shared_ptr<T const> lookup(uint64_t const key, F const& decode)
+        {
+            auto const index = shard_index(key);
+            auto& shard = m_shards[index];
+
+            {
+                std::lock_guard const guard(shard.lock);
+                auto found = shard.entries.find(key);
+
+                if (found != shard.entries.end())
+                {
+                    ++shard.counts.hits;
+                    shard.order.splice(shard.order.begin(), shard.order, found->second.position);
+                    return std::static_pointer_cast<T const>(found->second.value);
+                }
+
+                ++shard.counts.misses;
+            }
+
+            // Decode without holding the lock. If another thread decodes the same blob in the meantime, the first
+            // result to be inserted is kept.
+            auto decoded = std::make_shared<entry<T>>();
+            decoded->value.emplace(decode(&decoded->resource));
+            std::shared_ptr<T const> result(decoded, &*decoded->value);
+            std::size_t const size = sizeof(entry<T>) + decoded->resource.allocated;
+
+            if (size > m_budget)
+            {
+                return result;
+            }
+
+            {
+                std::lock_guard const guard(shard.lock);
+                auto[found, inserted] = shard.entries.try_emplace(key, node{ result, size, {} });
+
+                if (!inserted)
+                {
+                    return std::static_pointer_cast<T const>(found->second.value);
+                }
+
+                shard.order.push_front(key);
+                found->second.position = shard.order.begin();
+                shard.counts.bytes += size;
+                m_bytes += size;
+                evict(shard, key);
+            }
+
+            // Only one shard is locked at a time, so concurrent inserts cannot deadlock. The new entry goes last,
+            // and only if every other entry has been evicted and the memo is still over budget.
+            for (std::size_t offset = 1; offset < shard_count && m_bytes.load(std::memory_order_relaxed) > m_budget; ++offset)
+            {
+                auto& other = m_shards[(index + offset) % shard_count];
+                std::lock_guard const guard(other.lock);
+                evict(other, std::nullopt);
+            }
+
+            if (m_bytes.load(std::memory_order_relaxed) > m_budget)
+            {
+                std::lock_guard const guard(shard.lock);
+                evict(shard, std::nullopt);
+            }
+
+            return result;
+        }
+
+        std::size_t const m_budget;
+        std::atomic<std::size_t> m_bytes{};
+        std::array<shard, shard_count> m_shards;
+    };
+
+    inline void database::enable_memo(std::size_t const budget)
+    {
+        m_memo = std::make_shared<signature_memo>(budget);
+    }
+
+    // These decode through the database's memo when one is enabled and decode afresh otherwise.
+    inline std::shared_ptr<MethodDefSig const> memoized_signature(MethodDef const& method)
+    {
+        if (auto const memo = method.get_database().memo())
+        {
+            return memo->signature(method);
+        }
+
+        return std::make_shared<MethodDefSig const>(method.Signature());
+    }
+
+    inline std::shared_ptr<MethodDefSig const> memoized_signature(MemberRef const& member)
+    {
+        if (auto const memo = member.get_database().memo())
+        {
+            return memo->signature(member);
+        }
+
+        return std::make_shared<MethodDefSig const>(member.MethodSignature());
+    }
+
+    inline std::shared_ptr<CustomAttributeSig const> memoized_value(CustomAttribute const& attribute)
+    {
+        if (auto const memo = attribute.get_database().memo())
+        {
+            return memo->value(attribute);
+        }
+
+        return std::make_shared<CustomAttributeSig const>(attribute.Value());
+    }
+}
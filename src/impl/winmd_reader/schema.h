@@ -12,7 +12,7 @@ namespace winmd::reader
 		All = X64 | X86 | Arm64
 	};
 
-	auto ArchesToName(Architecture arches)
+	inline auto ArchesToName(Architecture arches)
 	{
 		std::string str;
 		if (arches != Architecture::None)
@@ -48,42 +48,44 @@ namespace winmd::reader
     template<class T>
 	Architecture GetSupportedArchitectures(const T& type);
 
+    // A string with its hash_string hash, computed once (at compile time for literals) so that comparisons
+    // against the database's string table can reject mismatches without touching the heap.
+    struct hashed_string
+    {
+        constexpr hashed_string(std::string_view const& value) noexcept :
+            value(value),
+            hash(impl::hash_string(value))
+        {
+        }
+
+        constexpr hashed_string(char const* value) noexcept :
+            hashed_string(std::string_view{ value })
+        {
+        }
+
+        hashed_string(std::string const& value) noexcept :
+            hashed_string(std::string_view{ value })
+        {
+        }
+
+        std::string_view value;
+        uint64_t hash;
+    };
+
     template<class T>
     struct TypeBase
     {
 		auto TypeDisplayName() const
 		{
-            T* pThis = (T*)this;
-			return pThis->get_string(1);
+            return static_cast<T const*>(this)->get_string(1);
 		}
 
-	private:
-        uint32_t m_index_last;
-        std::string_view full_type_name;
-		static void CheckForInitializeFullTypeName(TypeBase* pThis)
-		{
-            T* pThisT = (T*)pThis;
-			if (pThis->m_index_last != pThisT->m_index || pThis->full_type_name.empty())
-			{
-                pThis->m_index_last = pThisT->m_index;
-
-				std::string name(pThis->TypeDisplayName());
-				Architecture arches = GetSupportedArchitectures(*pThisT);
-				if (arches != Architecture::None)
-				{
-					name += "@";
-					name += ArchesToName(arches);
-				}
-                pThis->full_type_name = _strdup(name.c_str());//std::string_view̫ӵˣһŻơʱڴй¶עҪ޸
-			}
-		}
-	public:
-		auto TypeName() const
-		{
-            CheckForInitializeFullTypeName((TypeBase*)this);
-            return full_type_name;
-		}
+        // The display name, decorated with "@" and the supported architectures when the type carries a
+        // SupportedArchitectureAttribute. Decorated names are built once per row and owned by the database.
+        std::string_view TypeName() const;
 
+        // Equivalent to TypeNamespace() == type_namespace && TypeName() == type_name.
+        bool has_name(hashed_string const& type_namespace, hashed_string const& type_name) const;
     };
 
     struct TypeRef : row_base<TypeRef>, TypeBase<TypeRef>
@@ -117,15 +119,13 @@ namespace winmd::reader
             return get_coded_index<CustomAttributeType>(1);
         }
 
-        auto Value() const;
+        auto Value(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
 
         auto TypeNamespaceAndName() const;
     };
 
     struct TypeDef : row_base<TypeDef>, TypeBase<TypeDef>
     {
-        TypeDef* next = nullptr;
-
         using row_base::row_base;
 
         auto Flags() const
@@ -159,6 +159,10 @@ namespace winmd::reader
         auto get_enum_definition() const;
     };
 
+    // A TypeDef is only a table pointer and a row index, so the cache can store and copy it freely.
+    static_assert(std::is_trivially_copyable_v<TypeDef>);
+    static_assert(sizeof(TypeDef) == sizeof(row_base<TypeDef>));
+
     struct MethodDef : row_base<MethodDef>
     {
         using row_base::row_base;
@@ -183,7 +187,13 @@ namespace winmd::reader
             return get_string(3);
         }
 
-        MethodDefSig Signature() const
+        MethodDefSig Signature(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+        {
+            auto cursor = get_blob(4);
+            return{ get_table(), cursor, resource };
+        }
+
+        MethodDefSigView SignatureView() const
         {
             auto cursor = get_blob(4);
             return{ get_table(), cursor };
@@ -214,7 +224,13 @@ namespace winmd::reader
             return get_string(1);
         }
 
-        MethodDefSig MethodSignature() const
+        MethodDefSig MethodSignature(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+        {
+            auto cursor = get_blob(2);
+            return{ get_table(), cursor, resource };
+        }
+
+        MethodDefSigView MethodSignatureView() const
         {
             auto cursor = get_blob(2);
             return{ get_table(), cursor };
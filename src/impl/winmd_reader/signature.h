@@ -1,36 +1,128 @@
 
 namespace winmd::reader
 {
+    // How to extract a compressed integer from the big-endian word that starts at its first byte, indexed by the
+    // top three bits of that byte. A zero length marks an invalid encoding.
+    struct compressed_format
+    {
+        uint8_t length;
+        uint8_t shift;
+        uint32_t mask;
+    };
+
+    inline constexpr compressed_format compressed_formats[8]
+    {
+        { 1, 24, 0x7f }, { 1, 24, 0x7f }, { 1, 24, 0x7f }, { 1, 24, 0x7f },
+        { 2, 16, 0x3fff }, { 2, 16, 0x3fff },
+        { 4, 0, 0x1fffffff },
+        { 0, 0, 0 },
+    };
+
+    // Decodes the compressed integer at data, which must be followed by at least four readable bytes, without
+    // branching on its length.
+    inline uint32_t uncompress_unsigned_unchecked(uint8_t const*& data)
+    {
+        auto const& format = compressed_formats[*data >> 5];
+
+        if (!format.length)
+        {
+            impl::throw_invalid("Invalid compressed integer in blob");
+        }
+
+        uint32_t const word = (uint32_t{ data[0] } << 24) | (uint32_t{ data[1] } << 16) | (uint32_t{ data[2] } << 8) | data[3];
+        data += format.length;
+        return (word >> format.shift) & format.mask;
+    }
+
     inline uint32_t uncompress_unsigned(byte_view& cursor)
     {
         auto data = cursor.begin();
-        uint32_t value;
-        uint32_t length;
-        if ((*data & 0x80) == 0x00)
+
+        if (cursor.size() >= 4)
         {
-            length = 1;
-            value = *data;
+            if (*data < 0x80)
+            {
+                cursor = { data + 1, cursor.end() };
+                return *data;
+            }
+
+            auto const value = uncompress_unsigned_unchecked(data);
+            cursor = { data, cursor.end() };
+            return value;
         }
-        else if ((*data & 0xc0) == 0x80)
+
+        // Within four bytes of the end, where the word read above would overrun the blob.
+        if (!cursor.size())
         {
-            length = 2;
-            value = (*data++ & 0x3f) << 8;
-            value |= *data;
+            impl::throw_invalid("Buffer too small");
         }
-        else if ((*data & 0xe0) == 0xc0)
+
+        auto const& format = compressed_formats[*data >> 5];
+
+        if (!format.length)
         {
-            length = 4;
-            value = (*data++ & 0x1f) << 24;
-            value |= *data++ << 16;
-            value |= *data++ << 8;
-            value |= *data;
+            impl::throw_invalid("Invalid compressed integer in blob");
         }
-        else
+
+        if (format.length > cursor.size())
         {
-            impl::throw_invalid("Invalid compressed integer in blob");
+            impl::throw_invalid("Buffer too small");
         }
-        cursor = cursor.seek(length);
-        return value;
+
+        uint32_t value{};
+
+        for (uint32_t byte = 0; byte < format.length; ++byte)
+        {
+            value = (value << 8) | data[byte];
+        }
+
+        cursor = { data + format.length, cursor.end() };
+        return value & format.mask;
+    }
+
+    // Decodes a run of count compressed integers into values. A run that cannot reach the end of the blob, which
+    // is nearly every run, is decoded with a single bounds check.
+    inline void uncompress_unsigned(byte_view& cursor, uint32_t* const values, uint32_t const count)
+    {
+        if (cursor.size() / 4 < count)
+        {
+            for (uint32_t index = 0; index < count; ++index)
+            {
+                values[index] = uncompress_unsigned(cursor);
+            }
+
+            return;
+        }
+
+        auto data = cursor.begin();
+
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            values[index] = *data < 0x80 ? *data++ : uncompress_unsigned_unchecked(data);
+        }
+
+        cursor = { data, cursor.end() };
+    }
+
+    template <uint32_t Count>
+    std::array<uint32_t, Count> uncompress_unsigned(byte_view& cursor)
+    {
+        std::array<uint32_t, Count> values;
+        uncompress_unsigned(cursor, values.data(), Count);
+        return values;
+    }
+
+    // Element types are single bytes (ECMA-335 II.23.1.16), so they are read without decoding a compressed integer.
+    inline ElementType read_element_type(byte_view& cursor)
+    {
+        if (!cursor.size())
+        {
+            impl::throw_invalid("Buffer too small");
+        }
+
+        auto const data = cursor.begin();
+        cursor = { data + 1, cursor.end() };
+        return static_cast<ElementType>(*data);
     }
 
     template <typename T>
@@ -58,6 +150,9 @@ namespace winmd::reader
         return result;
     }
 
+    // The signature types below decode a blob eagerly. Every container in a decoded tree is allocated from the
+    // memory resource passed to its constructor, so a caller can pass an arena such as a
+    // std::pmr::monotonic_buffer_resource and release a whole pass worth of signatures at once.
     struct CustomModSig;
     struct FieldSig;
     struct GenericTypeInstSig;
@@ -70,8 +165,16 @@ namespace winmd::reader
 
     struct CustomModSig
     {
+        CustomModSig() noexcept = default;
+
         CustomModSig(table_base const* table, byte_view& data)
-            : m_cmod(uncompress_enum<ElementType>(data))
+            : CustomModSig(table, read_element_type(data), data)
+        {
+        }
+
+        // For a parser that has already read the modifier's element type.
+        CustomModSig(table_base const* table, ElementType const cmod, byte_view& data)
+            : m_cmod(cmod)
             , m_type(table, uncompress_unsigned(data))
         {
             XLANG_ASSERT(m_cmod == ElementType::CModReqd || m_cmod == ElementType::CModOpt);
@@ -88,18 +191,18 @@ namespace winmd::reader
         }
 
     private:
-        ElementType m_cmod;
+        ElementType m_cmod{};
         coded_index<TypeDefOrRef> m_type;
     };
 
     struct GenericTypeInstSig
     {
-        GenericTypeInstSig(table_base const* table, byte_view& data);
+        GenericTypeInstSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
         GenericTypeInstSig(coded_index<TypeDefOrRef> type, std::vector<TypeSig>&& args)
             : m_type(type)
             , m_generic_arg_count(static_cast<uint32_t>(args.size()))
-            , m_generic_args(std::move(args))
+            , m_generic_args(std::make_move_iterator(args.begin()), std::make_move_iterator(args.end()))
         {
             // If constructing directly, probably don't care about m_class_or_value
         }
@@ -128,28 +231,45 @@ namespace winmd::reader
         ElementType m_class_or_value{};
         coded_index<TypeDefOrRef> m_type;
         uint32_t m_generic_arg_count;
-        std::vector<TypeSig> m_generic_args;
+        std::pmr::vector<TypeSig> m_generic_args;
     };
 
-    inline std::vector<CustomModSig> parse_cmods(table_base const* table, byte_view& data)
+    inline bool is_cmod(ElementType const element_type) noexcept
+    {
+        return element_type == ElementType::CModOpt || element_type == ElementType::CModReqd;
+    }
+
+    // Reads the custom modifiers that start with element_type, which has already been read, into cmod and returns
+    // the element type that follows them.
+    inline ElementType parse_cmods(table_base const* table, ElementType element_type, byte_view& data, std::pmr::vector<CustomModSig>& cmod)
     {
-        std::vector<CustomModSig> result;
+        while (is_cmod(element_type))
+        {
+            cmod.emplace_back(table, element_type, data);
+            element_type = read_element_type(data);
+        }
+
+        return element_type;
+    }
+
+    inline std::pmr::vector<CustomModSig> parse_cmods(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        std::pmr::vector<CustomModSig> result(resource);
         auto cursor = data;
 
-        for (auto element_type = uncompress_enum<ElementType>(cursor);
-            element_type == ElementType::CModOpt || element_type == ElementType::CModReqd;
-            element_type = uncompress_enum<ElementType>(cursor))
+        for (auto element_type = read_element_type(cursor); is_cmod(element_type); element_type = read_element_type(cursor))
         {
-            result.emplace_back(table, data);
-            cursor = data;
+            result.emplace_back(table, element_type, cursor);
+            data = cursor;
         }
+
         return result;
     }
 
     inline bool parse_szarray(table_base const*, byte_view& data)
     {
         auto cursor = data;
-        if (uncompress_enum<ElementType>(cursor) == ElementType::SZArray)
+        if (read_element_type(cursor) == ElementType::SZArray)
         {
             data = cursor;
             return true;
@@ -160,7 +280,7 @@ namespace winmd::reader
     inline bool parse_array(table_base const*, byte_view& data)
     {
         auto cursor = data;
-        if (uncompress_enum<ElementType>(cursor) == ElementType::Array)
+        if (read_element_type(cursor) == ElementType::Array)
         {
             data = cursor;
             return true;
@@ -168,25 +288,25 @@ namespace winmd::reader
         return false;
     }
 
-    inline std::pair<uint32_t, std::vector<uint32_t>> parse_array_sizes(table_base const*, byte_view& data)
+    inline std::pair<uint32_t, std::pmr::vector<uint32_t>> parse_array_sizes(table_base const*, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
     {
-        uint32_t const rank = uncompress_unsigned(data);
-        uint32_t const num_sizes = uncompress_unsigned(data);
-        std::vector<uint32_t> sizes;
-        sizes.reserve(num_sizes);
-        for (uint32_t i = 0; i < num_sizes; ++i)
+        auto const [rank, num_sizes] = uncompress_unsigned<2>(data);
+
+        if (num_sizes > data.size())
         {
-            auto size = uncompress_unsigned(data);
-            sizes.push_back(size);
+            impl::throw_invalid("Invalid blob array size");
         }
-        return { rank, sizes };
+
+        std::pmr::vector<uint32_t> sizes(num_sizes, resource);
+        uncompress_unsigned(data, sizes.data(), num_sizes);
+        return { rank, std::move(sizes) };
     }
 
     inline int parse_ptr(table_base const*, byte_view& data)
     {
         auto cursor = data;
         int result = 0;
-        while(uncompress_enum<ElementType>(cursor) == ElementType::Ptr)
+        while (read_element_type(cursor) == ElementType::Ptr)
         {
             ++result;
             data = cursor;
@@ -207,17 +327,40 @@ namespace winmd::reader
     struct TypeSig
     {
         using value_type = std::variant<ElementType, coded_index<TypeDefOrRef>, GenericTypeIndex, GenericTypeInstSig, GenericMethodTypeIndex>;
-        TypeSig(table_base const* table, byte_view& data)
-            : m_is_szarray(parse_szarray(table, data))
-            , m_is_array(parse_array(table, data))
-            , m_ptr_count(parse_ptr(table, data))
-            , m_cmod(parse_cmods(table, data))
-            , m_element_type(parse_element_type(data))
-            , m_type(ParseType(table, data))
+        TypeSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : TypeSig(table, read_element_type(data), data, resource)
+        {
+        }
+
+        // For a parser that has already read the first element type, reading every later byte exactly once.
+        TypeSig(table_base const* table, ElementType element_type, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_cmod(resource)
+            , m_array_sizes(resource)
         {
+            if (element_type == ElementType::SZArray)
+            {
+                m_is_szarray = true;
+                element_type = read_element_type(data);
+            }
+
+            if (element_type == ElementType::Array)
+            {
+                m_is_array = true;
+                element_type = read_element_type(data);
+            }
+
+            while (element_type == ElementType::Ptr)
+            {
+                ++m_ptr_count;
+                element_type = read_element_type(data);
+            }
+
+            m_element_type = parse_cmods(table, element_type, data, m_cmod);
+            m_type = ParseType(table, m_element_type, data, resource);
+
             if (m_is_array)
             {
-                std::tie(m_array_rank, m_array_sizes) = parse_array_sizes(table, data);
+                std::tie(m_array_rank, m_array_sizes) = parse_array_sizes(table, data, resource);
             }
         }
 
@@ -252,7 +395,7 @@ namespace winmd::reader
             return m_array_rank;
         }
 
-        std::vector<uint32_t> const& array_sizes() const noexcept
+        std::pmr::vector<uint32_t> const& array_sizes() const noexcept
         {
             return m_array_sizes;
         }
@@ -263,27 +406,21 @@ namespace winmd::reader
         }
 
     private:
-        static ElementType parse_element_type(byte_view& data)
-        {
-            auto cursor = data;
-            return uncompress_enum<ElementType>(cursor);
-        }
-
-        static value_type ParseType(table_base const* table, byte_view& data);
+        static value_type ParseType(table_base const* table, ElementType element_type, byte_view& data, std::pmr::memory_resource* resource);
         bool m_is_szarray{};
         bool m_is_array{};
         int m_ptr_count{};
-        std::vector<CustomModSig> m_cmod;
+        std::pmr::vector<CustomModSig> m_cmod;
         ElementType m_element_type{};
         value_type m_type;
         uint32_t m_array_rank{};
-        std::vector<uint32_t> m_array_sizes;
+        std::pmr::vector<uint32_t> m_array_sizes;
     };
 
     inline bool is_by_ref(byte_view& data)
     {
         auto cursor = data;
-        auto element_type = uncompress_enum<ElementType>(cursor);
+        auto element_type = read_element_type(cursor);
         if (element_type == ElementType::ByRef)
         {
             data = cursor;
@@ -296,12 +433,27 @@ namespace winmd::reader
         }
     }
 
+    // Reads the custom modifiers and ByRef marker before a parameter or return type, and returns the element type
+    // that follows them.
+    inline ElementType parse_param_prefix(table_base const* table, byte_view& data, std::pmr::vector<CustomModSig>& cmod, bool& byref)
+    {
+        auto element_type = parse_cmods(table, read_element_type(data), data, cmod);
+        byref = element_type == ElementType::ByRef;
+
+        if (byref)
+        {
+            element_type = read_element_type(data);
+        }
+
+        XLANG_ASSERT(element_type != ElementType::TypedByRef);
+        return element_type;
+    }
+
     struct ParamSig
     {
-        ParamSig(table_base const* table, byte_view& data)
-            : m_cmod(parse_cmods(table, data))
-            , m_byref(is_by_ref(data))
-            , m_type(table, data)
+        ParamSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_cmod(resource)
+            , m_type(table, parse_param_prefix(table, data, m_cmod, m_byref), data, resource)
         {
         }
 
@@ -321,26 +473,21 @@ namespace winmd::reader
         }
 
     private:
-        std::vector<CustomModSig> m_cmod;
-        bool m_byref;
+        std::pmr::vector<CustomModSig> m_cmod;
+        bool m_byref{};
         TypeSig m_type;
     };
 
     struct RetTypeSig
     {
-        RetTypeSig(table_base const* table, byte_view& data)
-            : m_cmod(parse_cmods(table, data))
-            , m_byref(is_by_ref(data))
+        RetTypeSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_cmod(resource)
         {
-            auto cursor = data;
-            auto element_type = uncompress_enum<ElementType>(cursor);
-            if (element_type == ElementType::Void)
-            {
-                data = cursor;
-            }
-            else
+            auto const element_type = parse_param_prefix(table, data, m_cmod, m_byref);
+
+            if (element_type != ElementType::Void)
             {
-                m_type.emplace(table, data);
+                m_type.emplace(table, element_type, data, resource);
             }
         }
 
@@ -365,18 +512,19 @@ namespace winmd::reader
         }
 
     private:
-        std::vector<CustomModSig> m_cmod;
-        bool m_byref;
+        std::pmr::vector<CustomModSig> m_cmod;
+        bool m_byref{};
         std::optional<TypeSig> m_type;
     };
 
     struct MethodDefSig
     {
-        MethodDefSig(table_base const* table, byte_view& data)
+        MethodDefSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
             : m_calling_convention(uncompress_enum<CallingConvention>(data))
             , m_generic_param_count(enum_mask(m_calling_convention, CallingConvention::Generic) == CallingConvention::Generic ? uncompress_unsigned(data) : 0)
             , m_param_count(uncompress_unsigned(data))
-            , m_ret_type(table, data)
+            , m_ret_type(table, data, resource)
+            , m_params(resource)
         {
             if (m_param_count > data.size())
             {
@@ -385,7 +533,7 @@ namespace winmd::reader
             m_params.reserve(m_param_count);
             for (uint32_t count = 0; count < m_param_count; ++count)
             {
-                m_params.emplace_back(table, data);
+                m_params.emplace_back(table, data, resource);
             }
         }
 
@@ -414,15 +562,15 @@ namespace winmd::reader
         uint32_t m_generic_param_count;
         uint32_t m_param_count;
         RetTypeSig m_ret_type;
-        std::vector<ParamSig> m_params;
+        std::pmr::vector<ParamSig> m_params;
     };
 
     struct FieldSig
     {
-        FieldSig(table_base const* table, byte_view& data)
+        FieldSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
             : m_calling_convention(check_convention(data))
-            , m_cmod(parse_cmods(table, data))
-            , m_type(table, data)
+            , m_cmod(resource)
+            , m_type(table, parse_cmods(table, read_element_type(data), data, m_cmod), data, resource)
         {}
 
         auto CustomMod() const noexcept
@@ -446,17 +594,18 @@ namespace winmd::reader
             return conv;
         }
         CallingConvention m_calling_convention;
-        std::vector<CustomModSig> m_cmod;
+        std::pmr::vector<CustomModSig> m_cmod;
         TypeSig m_type;
     };
 
     struct PropertySig
     {
-        PropertySig(table_base const* table, byte_view& data)
+        PropertySig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
             : m_calling_convention(check_convention(data))
             , m_param_count(uncompress_unsigned(data))
-            , m_cmod(parse_cmods(table, data))
-            , m_type(table, data)
+            , m_cmod(resource)
+            , m_type(table, parse_cmods(table, read_element_type(data), data, m_cmod), data, resource)
+            , m_params(resource)
         {
             if (m_param_count > data.size())
             {
@@ -465,7 +614,7 @@ namespace winmd::reader
             m_params.reserve(m_param_count);
             for (uint32_t count = 0; count < m_param_count; ++count)
             {
-                m_params.emplace_back(table, data);
+                m_params.emplace_back(table, data, resource);
             }
         }
 
@@ -491,15 +640,15 @@ namespace winmd::reader
         }
         CallingConvention m_calling_convention;
         uint32_t m_param_count;
-        std::vector<CustomModSig> m_cmod;
+        std::pmr::vector<CustomModSig> m_cmod;
         TypeSig m_type;
-        std::vector<ParamSig> m_params;
+        std::pmr::vector<ParamSig> m_params;
     };
 
     struct TypeSpecSig
     {
-        TypeSpecSig(table_base const* table, byte_view& data)
-            : m_type(ParseType(table, data))
+        TypeSpecSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_type(ParseType(table, data, resource))
         {
         }
 
@@ -509,20 +658,23 @@ namespace winmd::reader
         }
 
     private:
-        static GenericTypeInstSig ParseType(table_base const* table, byte_view& data)
+        static GenericTypeInstSig ParseType(table_base const* table, byte_view& data, std::pmr::memory_resource* resource)
         {
-            [[maybe_unused]] auto element_type = uncompress_enum<ElementType>(data);
+            [[maybe_unused]] auto element_type = read_element_type(data);
             XLANG_ASSERT(element_type == ElementType::GenericInst);
-            return { table, data };
+            return { table, data, resource };
         }
         GenericTypeInstSig m_type;
     };
 
-    inline GenericTypeInstSig::GenericTypeInstSig(table_base const* table, byte_view& data)
-        : m_class_or_value(uncompress_enum<ElementType>(data))
-        , m_type(table, uncompress_unsigned(data))
-        , m_generic_arg_count(uncompress_unsigned(data))
+    inline GenericTypeInstSig::GenericTypeInstSig(table_base const* table, byte_view& data, std::pmr::memory_resource* resource)
+        : m_class_or_value(read_element_type(data))
+        , m_generic_args(resource)
     {
+        auto const [type, count] = uncompress_unsigned<2>(data);
+        m_type = { table, type };
+        m_generic_arg_count = count;
+
         if (!(m_class_or_value == ElementType::Class || m_class_or_value == ElementType::ValueType))
         {
             impl::throw_invalid("Generic type instantiation signatures must begin with either ELEMENT_TYPE_CLASS or ELEMENT_TYPE_VALUE");
@@ -535,13 +687,12 @@ namespace winmd::reader
         m_generic_args.reserve(m_generic_arg_count);
         for (uint32_t arg = 0; arg < m_generic_arg_count; ++arg)
         {
-            m_generic_args.emplace_back(table, data);
+            m_generic_args.emplace_back(table, data, resource);
         }
     }
 
-    inline TypeSig::value_type TypeSig::ParseType(table_base const* table, byte_view& data)
+    inline TypeSig::value_type TypeSig::ParseType(table_base const* table, ElementType const element_type, byte_view& data, std::pmr::memory_resource* resource)
     {
-        auto element_type = uncompress_enum<ElementType>(data);
         switch (element_type)
         {
         case ElementType::Boolean:
@@ -570,7 +721,7 @@ namespace winmd::reader
             break;
 
         case ElementType::GenericInst:
-            return GenericTypeInstSig{ table, data };
+            return GenericTypeInstSig{ table, data, resource };
             break;
 
         case ElementType::Var:
@@ -0,0 +1,517 @@
+
+namespace winmd::reader
+{
+    // Lazy counterparts of the signature types in signature.h. A view records where each part of a signature
+    // starts in the blob and decodes it on demand, so walking a signature never allocates. Views refer directly
+    // to the database's blob heap and remain valid as long as the database does.
+
+    struct GenericTypeInstSigView;
+    struct MethodDefSigView;
+    struct ParamSigView;
+    struct RetTypeSigView;
+    struct TypeSigView;
+
+    // Forward range decoding a run of consecutive signature elements in place.
+    template <typename T>
+    struct sig_range
+    {
+        struct iterator
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T const*;
+            using reference = T const&;
+
+            iterator() noexcept = default;
+
+            iterator(table_base const* table, byte_view const& data, uint32_t const remaining) :
+                m_table(table),
+                m_next(data),
+                m_remaining(remaining)
+            {
+                if (m_remaining)
+                {
+                    parse(m_value, m_table, m_next);
+                }
+            }
+
+            reference operator*() const noexcept
+            {
+                return m_value;
+            }
+
+            pointer operator->() const noexcept
+            {
+                return &m_value;
+            }
+
+            iterator& operator++()
+            {
+                XLANG_ASSERT(m_remaining);
+
+                if (--m_remaining)
+                {
+                    parse(m_value, m_table, m_next);
+                }
+
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                auto previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(iterator const& other) const noexcept
+            {
+                return m_remaining == other.m_remaining;
+            }
+
+            bool operator!=(iterator const& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+        private:
+            // Decodes the next element directly over the current one. Views are large enough that constructing a
+            // temporary and copying it in costs as much as the decode itself.
+            static void parse(T& value, table_base const* table, byte_view& data)
+            {
+                static_assert(std::is_trivially_destructible_v<T>);
+
+                if constexpr (std::is_same_v<T, uint32_t>)
+                {
+                    value = uncompress_unsigned(data);
+                }
+                else
+                {
+                    new (&value) T{ table, data };
+                }
+            }
+
+            table_base const* m_table{};
+            byte_view m_next;
+            uint32_t m_remaining{};
+            T m_value{};
+        };
+
+        sig_range() noexcept = default;
+
+        sig_range(table_base const* table, byte_view const& data, uint32_t const count) noexcept :
+            m_table(table),
+            m_first(data.begin()),
+            m_last(data.end()),
+            m_count(count)
+        {
+        }
+
+        iterator begin() const
+        {
+            return { m_table, { m_first, m_last }, m_count };
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+
+        uint32_t size() const noexcept
+        {
+            return m_count;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_count == 0;
+        }
+
+    private:
+        // Raw pointers rather than a byte_view keep ranges, and the views holding them, trivially copyable.
+        table_base const* m_table{};
+        uint8_t const* m_first{};
+        uint8_t const* m_last{};
+        uint32_t m_count{};
+    };
+
+    // Skips the custom modifiers at the front of data, returning the range that covers them.
+    inline sig_range<CustomModSig> skip_cmods(table_base const* table, byte_view& data)
+    {
+        auto const first = data;
+        uint32_t count{};
+
+        for (auto cursor = data; is_cmod(read_element_type(cursor)); ++count)
+        {
+            uncompress_unsigned(cursor);
+            data = cursor;
+        }
+
+        return { table, first, count };
+    }
+
+    // Skips the custom modifiers that start with element_type, which has just been read from data, and replaces
+    // element_type with the one that follows them. Element types are single bytes, so the first modifier starts
+    // one byte before data.
+    inline sig_range<CustomModSig> skip_cmods(table_base const* table, ElementType& element_type, byte_view& data)
+    {
+        byte_view const first{ data.begin() - 1, data.end() };
+        uint32_t count{};
+
+        for (; is_cmod(element_type); ++count)
+        {
+            uncompress_unsigned(data);
+            element_type = read_element_type(data);
+        }
+
+        return { table, first, count };
+    }
+
+    // Decodes the custom modifiers and ByRef marker that precede a parameter or return type, reading each byte
+    // once, and returns the element type that follows them.
+    inline ElementType parse_param_prefix(table_base const* table, byte_view& data, sig_range<CustomModSig>& cmod, bool& byref)
+    {
+        auto element_type = read_element_type(data);
+
+        if (is_cmod(element_type))
+        {
+            cmod = skip_cmods(table, element_type, data);
+        }
+
+        byref = element_type == ElementType::ByRef;
+
+        if (byref)
+        {
+            element_type = read_element_type(data);
+        }
+
+        XLANG_ASSERT(element_type != ElementType::TypedByRef);
+        return element_type;
+    }
+
+    struct GenericTypeInstSigView
+    {
+        GenericTypeInstSigView() noexcept = default;
+        GenericTypeInstSigView(table_base const* table, byte_view& data);
+
+        ElementType ClassOrValueType() const noexcept
+        {
+            return m_class_or_value;
+        }
+
+        coded_index<TypeDefOrRef> GenericType() const noexcept
+        {
+            return m_type;
+        }
+
+        uint32_t GenericArgCount() const noexcept
+        {
+            return m_generic_args.size();
+        }
+
+        sig_range<TypeSigView> GenericArgs() const noexcept
+        {
+            return m_generic_args;
+        }
+
+    private:
+        ElementType m_class_or_value{};
+        coded_index<TypeDefOrRef> m_type;
+        sig_range<TypeSigView> m_generic_args;
+    };
+
+    struct TypeSigView
+    {
+        using value_type = std::variant<ElementType, coded_index<TypeDefOrRef>, GenericTypeIndex, GenericTypeInstSigView, GenericMethodTypeIndex>;
+
+        TypeSigView() noexcept = default;
+
+        TypeSigView(table_base const* table, byte_view& data) :
+            TypeSigView(table, read_element_type(data), data)
+        {
+        }
+
+        // For a parser that has already read the first element type. Each later byte is read once.
+        TypeSigView(table_base const* table, ElementType element_type, byte_view& data)
+        {
+            if (element_type == ElementType::SZArray)
+            {
+                m_is_szarray = true;
+                element_type = read_element_type(data);
+            }
+
+            if (element_type == ElementType::Array)
+            {
+                m_is_array = true;
+                element_type = read_element_type(data);
+            }
+
+            while (element_type == ElementType::Ptr)
+            {
+                ++m_ptr_count;
+                element_type = read_element_type(data);
+            }
+
+            if (is_cmod(element_type))
+            {
+                m_cmod = skip_cmods(table, element_type, data);
+            }
+
+            parse_type(table, element_type, data);
+
+            if (m_is_array)
+            {
+                auto const [rank, count] = uncompress_unsigned<2>(data);
+                m_array_rank = rank;
+                m_array_sizes = { table, data, count };
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    uncompress_unsigned(data);
+                }
+            }
+        }
+
+        value_type const& Type() const noexcept
+        {
+            return m_type;
+        }
+
+        sig_range<CustomModSig> CustomMod() const noexcept
+        {
+            return m_cmod;
+        }
+
+        ElementType element_type() const noexcept
+        {
+            return m_element_type;
+        }
+
+        bool is_szarray() const noexcept
+        {
+            return m_is_szarray;
+        }
+
+        bool is_array() const noexcept
+        {
+            return m_is_array;
+        }
+
+        uint32_t array_rank() const noexcept
+        {
+            return m_array_rank;
+        }
+
+        sig_range<uint32_t> array_sizes() const noexcept
+        {
+            return m_array_sizes;
+        }
+
+        int ptr_count() const noexcept
+        {
+            return m_ptr_count;
+        }
+
+    private:
+        // Constructs the variant in place; building it on the stack and copying it in is measurably slower.
+        void parse_type(table_base const* table, ElementType const element_type, byte_view& data)
+        {
+            m_element_type = element_type;
+
+            switch (m_element_type)
+            {
+            case ElementType::Boolean:
+            case ElementType::Char:
+            case ElementType::I1:
+            case ElementType::U1:
+            case ElementType::I2:
+            case ElementType::U2:
+            case ElementType::I4:
+            case ElementType::U4:
+            case ElementType::I8:
+            case ElementType::U8:
+            case ElementType::R4:
+            case ElementType::R8:
+            case ElementType::String:
+            case ElementType::Object:
+            case ElementType::U:
+            case ElementType::I:
+            case ElementType::Void:
+                m_type.emplace<ElementType>(m_element_type);
+                break;
+
+            case ElementType::Class:
+            case ElementType::ValueType:
+                m_type.emplace<coded_index<TypeDefOrRef>>(table, uncompress_unsigned(data));
+                break;
+
+            case ElementType::GenericInst:
+                m_type.emplace<GenericTypeInstSigView>(table, data);
+                break;
+
+            case ElementType::Var:
+                m_type.emplace<GenericTypeIndex>(GenericTypeIndex{ uncompress_unsigned(data) });
+                break;
+
+            case ElementType::MVar:
+                m_type.emplace<GenericMethodTypeIndex>(GenericMethodTypeIndex{ uncompress_unsigned(data) });
+                break;
+
+            default:
+                impl::throw_invalid("Unrecognized ELEMENT_TYPE encountered");
+            }
+        }
+
+        bool m_is_szarray{};
+        bool m_is_array{};
+        int m_ptr_count{};
+        sig_range<CustomModSig> m_cmod;
+        ElementType m_element_type{};
+        value_type m_type;
+        uint32_t m_array_rank{};
+        sig_range<uint32_t> m_array_sizes;
+    };
+
+    inline GenericTypeInstSigView::GenericTypeInstSigView(table_base const* table, byte_view& data) :
+        m_class_or_value(read_element_type(data))
+    {
+        if (!(m_class_or_value == ElementType::Class || m_class_or_value == ElementType::ValueType))
+        {
+            impl::throw_invalid("Generic type instantiation signatures must begin with either ELEMENT_TYPE_CLASS or ELEMENT_TYPE_VALUE");
+        }
+
+        auto const [type, count] = uncompress_unsigned<2>(data);
+        m_type = { table, type };
+
+        if (count > data.size())
+        {
+            impl::throw_invalid("Invalid blob array size");
+        }
+
+        m_generic_args = { table, data, count };
+
+        for (uint32_t arg = 0; arg < count; ++arg)
+        {
+            TypeSigView{ table, data };
+        }
+    }
+
+    struct ParamSigView
+    {
+        ParamSigView() noexcept = default;
+
+        ParamSigView(table_base const* table, byte_view& data) :
+            m_type(table, parse_param_prefix(table, data, m_cmod, m_byref), data)
+        {
+        }
+
+        sig_range<CustomModSig> CustomMod() const noexcept
+        {
+            return m_cmod;
+        }
+
+        bool ByRef() const noexcept
+        {
+            return m_byref;
+        }
+
+        TypeSigView const& Type() const noexcept
+        {
+            return m_type;
+        }
+
+    private:
+        sig_range<CustomModSig> m_cmod;
+        bool m_byref{};
+        TypeSigView m_type;
+    };
+
+    struct RetTypeSigView
+    {
+        RetTypeSigView() noexcept = default;
+
+        RetTypeSigView(table_base const* table, byte_view& data)
+        {
+            auto const element_type = parse_param_prefix(table, data, m_cmod, m_byref);
+
+            if (element_type != ElementType::Void)
+            {
+                new (&m_type) TypeSigView{ table, element_type, data };
+                m_has_type = true;
+            }
+        }
+
+        sig_range<CustomModSig> CustomMod() const noexcept
+        {
+            return m_cmod;
+        }
+
+        bool ByRef() const noexcept
+        {
+            return m_byref;
+        }
+
+        TypeSigView const& Type() const noexcept
+        {
+            XLANG_ASSERT(m_has_type);
+            return m_type;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_has_type;
+        }
+
+    private:
+        sig_range<CustomModSig> m_cmod;
+        bool m_byref{};
+        bool m_has_type{};
+        TypeSigView m_type;
+    };
+
+    // Parameters are only decoded as Params() is iterated.
+    struct MethodDefSigView
+    {
+        MethodDefSigView(table_base const* table, byte_view& data) :
+            m_calling_convention(uncompress_enum<CallingConvention>(data)),
+            m_generic_param_count(enum_mask(m_calling_convention, CallingConvention::Generic) == CallingConvention::Generic ? uncompress_unsigned(data) : 0)
+        {
+            uint32_t const count = uncompress_unsigned(data);
+            m_ret_type = { table, data };
+
+            if (count > data.size())
+            {
+                impl::throw_invalid("Invalid blob array size");
+            }
+
+            m_params = { table, data, count };
+        }
+
+        CallingConvention CallConvention() const noexcept
+        {
+            return m_calling_convention;
+        }
+
+        uint32_t GenericParamCount() const noexcept
+        {
+            return m_generic_param_count;
+        }
+
+        RetTypeSigView const& ReturnType() const noexcept
+        {
+            return m_ret_type;
+        }
+
+        sig_range<ParamSigView> Params() const noexcept
+        {
+            return m_params;
+        }
+
+    private:
+        CallingConvention m_calling_convention;
+        uint32_t m_generic_param_count;
+        RetTypeSigView m_ret_type;
+        sig_range<ParamSigView> m_params;
+    };
+}
@@ -0,0 +1,709 @@
+namespace winmd::impl
+{
+    // The sidecar file written for cache::snapshot: a header followed by arrays of the trivially copyable records
+    // below and a pool of strings, so that a mapped file is used in place. Rows are stored as the ordinal of their
+    // file and their row index, since database ids differ between processes. Bump snapshot_version whenever the
+    // layout or the meaning of any record changes.
+    constexpr uint32_t snapshot_magic = 0x53444d57; // "WMDS"
+    constexpr uint32_t snapshot_version = 1;
+    constexpr uint32_t snapshot_none = UINT32_MAX;
+
+    struct snapshot_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t files;
+        uint32_t namespaces;
+        uint32_t members;
+        uint32_t variant_lists;
+        uint32_t variants;
+        uint32_t categories;
+        uint32_t nested;
+        uint32_t index_capacity;
+        uint32_t nested_index_capacity;
+        uint32_t strings;
+    };
+
+    struct snapshot_string
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct snapshot_type
+    {
+        uint32_t file;
+        uint32_t row;
+    };
+
+    struct snapshot_file
+    {
+        uint64_t size;
+        int64_t write_time;
+        uint64_t fingerprint;
+        snapshot_string path;
+    };
+
+    // The namespace's types, variant lists and category lists are ranges of the respective arrays. categories
+    // holds the start of the interfaces, classes, enums, structs, delegates, attributes and contracts lists, in
+    // that order, followed by the end of the last one.
+    struct snapshot_namespace
+    {
+        snapshot_string name;
+        uint32_t first_member;
+        uint32_t last_member;
+        uint32_t first_variant_list;
+        uint32_t last_variant_list;
+        std::array<uint32_t, 8> categories;
+    };
+
+    struct snapshot_member
+    {
+        snapshot_string name;
+        snapshot_type type;
+    };
+
+    struct snapshot_variant_list
+    {
+        snapshot_string name;
+        uint32_t first;
+        uint32_t last;
+    };
+
+    struct snapshot_variant
+    {
+        snapshot_type type;
+        uint32_t arches;
+    };
+
+    struct snapshot_nested
+    {
+        snapshot_type enclosing_type;
+        snapshot_type nested_type;
+    };
+
+    // An open-addressing slot of the (namespace, name) index. Empty slots have neither a member nor a variant list.
+    struct snapshot_entry
+    {
+        uint64_t hash;
+        snapshot_string type_namespace;
+        snapshot_string name;
+        uint32_t member;
+        uint32_t variant_list;
+    };
+
+    // An open-addressing slot of the (enclosing type, name) index of nested types. Empty slots have no type.
+    struct snapshot_nested_entry
+    {
+        uint64_t hash;
+        snapshot_type enclosing_type;
+        snapshot_string name;
+        snapshot_type type;
+        uint32_t decorated;
+        uint32_t padding;
+    };
+
+    // Byte offsets of the sections described by a header. Every section starts on an 8-byte boundary.
+    struct snapshot_layout
+    {
+        explicit snapshot_layout(snapshot_header const& header) noexcept :
+            files{ section<snapshot_file>(header.files) },
+            namespaces{ section<snapshot_namespace>(header.namespaces) },
+            members{ section<snapshot_member>(header.members) },
+            variant_lists{ section<snapshot_variant_list>(header.variant_lists) },
+            variants{ section<snapshot_variant>(header.variants) },
+            categories{ section<snapshot_type>(header.categories) },
+            nested{ section<snapshot_nested>(header.nested) },
+            index{ section<snapshot_entry>(header.index_capacity) },
+            nested_index{ section<snapshot_nested_entry>(header.nested_index_capacity) },
+            strings{ section<char>(header.strings) }
+        {
+        }
+
+        uint64_t size{ sizeof(snapshot_header) };
+        uint64_t files;
+        uint64_t namespaces;
+        uint64_t members;
+        uint64_t variant_lists;
+        uint64_t variants;
+        uint64_t categories;
+        uint64_t nested;
+        uint64_t index;
+        uint64_t nested_index;
+        uint64_t strings;
+
+    private:
+
+        template <typename T>
+        uint64_t section(uint32_t const count) noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            auto const offset = size;
+            size = (size + uint64_t{ count } * sizeof(T) + 7) & ~uint64_t{ 7 };
+            return offset;
+        }
+    };
+
+    inline uint64_t snapshot_key_hash(std::string_view const& type_namespace, std::string_view const& type_name) noexcept
+    {
+        return hash_string(type_name, hash_string("\0"sv, hash_string(type_namespace)));
+    }
+
+    inline uint64_t snapshot_nested_hash(snapshot_type const& enclosing_type, std::string_view const& name) noexcept
+    {
+        auto const row = (uint64_t{ enclosing_type.file } << 32) | enclosing_type.row;
+        return hash_string(name, hash_string({ reinterpret_cast<char const*>(&row), sizeof(row) }));
+    }
+
+    inline bool snapshot_file_matches(snapshot_file const& file, reader::database const& db)
+    {
+        std::error_code error;
+        auto const size = std::filesystem::file_size(db.path(), error);
+
+        if (error || size != file.size)
+        {
+            return false;
+        }
+
+        auto const write_time = std::filesystem::last_write_time(db.path(), error);
+
+        if (error || static_cast<int64_t>(write_time.time_since_epoch().count()) != file.write_time)
+        {
+            return false;
+        }
+
+        return db.fingerprint() == file.fingerprint;
+    }
+
+    // Collects the records of a snapshot in memory and writes them out in the layout above.
+    struct snapshot_writer
+    {
+        explicit snapshot_writer(std::vector<reader::database const*> databases) : m_databases{ std::move(databases) }
+        {
+        }
+
+        snapshot_string add_string(std::string_view const& value)
+        {
+            snapshot_string const result{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+            strings.append(value);
+            return result;
+        }
+
+        snapshot_type add_type(reader::TypeDef const& type) const
+        {
+            auto const db = std::find(m_databases.begin(), m_databases.end(), &type.get_database());
+
+            if (db == m_databases.end())
+            {
+                throw_invalid("Type '", type.TypeNamespace(), ".", type.TypeName(), "' does not belong to the cache");
+            }
+
+            return { static_cast<uint32_t>(db - m_databases.begin()), type.index() };
+        }
+
+        snapshot_entry& add_entry(snapshot_string const& type_namespace, snapshot_string const& name)
+        {
+            auto const hash = snapshot_key_hash(string(type_namespace), string(name));
+            auto const mask = index.size() - 1;
+
+            for (auto position = hash & mask;; position = (position + 1) & mask)
+            {
+                auto& entry = index[position];
+
+                if (entry.member == snapshot_none && entry.variant_list == snapshot_none)
+                {
+                    entry.hash = hash;
+                    entry.type_namespace = type_namespace;
+                    entry.name = name;
+                    return entry;
+                }
+
+                if (entry.hash == hash && string(entry.name) == string(name) && string(entry.type_namespace) == string(type_namespace))
+                {
+                    return entry;
+                }
+            }
+        }
+
+        void add_nested_entry(snapshot_type const& enclosing_type, snapshot_string const& name, snapshot_type const& type, bool const decorated)
+        {
+            auto const hash = snapshot_nested_hash(enclosing_type, string(name));
+            auto const mask = nested_index.size() - 1;
+            auto position = hash & mask;
+
+            while (nested_index[position].type.file != snapshot_none)
+            {
+                position = (position + 1) & mask;
+            }
+
+            nested_index[position] = { hash, enclosing_type, name, type, decorated, 0 };
+        }
+
+        // Sizes the open-addressing tables for the given number of keys, at most half full as in the cache.
+        void reserve(std::size_t const index_count, std::size_t const nested_count)
+        {
+            index.assign(capacity(index_count), { 0, {}, {}, snapshot_none, snapshot_none });
+            nested_index.assign(capacity(nested_count), { 0, {}, {}, { snapshot_none, 0 }, 0, 0 });
+        }
+
+        // Writes to a temporary file that is then renamed over path, so that concurrent readers see either the
+        // previous snapshot or the complete new one. Returns false if the file could not be written.
+        bool save(std::string const& path)
+        {
+            for (auto&& db : m_databases)
+            {
+                std::error_code error;
+                auto const size = std::filesystem::file_size(db->path(), error);
+                auto const write_time = std::filesystem::last_write_time(db->path(), error);
+
+                if (error)
+                {
+                    return false;
+                }
+
+                files.push_back({ size, static_cast<int64_t>(write_time.time_since_epoch().count()), db->fingerprint(), add_string(db->path()) });
+            }
+
+            snapshot_header const header
+            {
+                snapshot_magic,
+                snapshot_version,
+                static_cast<uint32_t>(files.size()),
+                static_cast<uint32_t>(namespaces.size()),
+                static_cast<uint32_t>(members.size()),
+                static_cast<uint32_t>(variant_lists.size()),
+                static_cast<uint32_t>(variants.size()),
+                static_cast<uint32_t>(categories.size()),
+                static_cast<uint32_t>(nested.size()),
+                static_cast<uint32_t>(index.size()),
+                static_cast<uint32_t>(nested_index.size()),
+                static_cast<uint32_t>(strings.size())
+            };
+
+            if (strings.size() > UINT32_MAX)
+            {
+                return false;
+            }
+
+            auto const unique = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                static_cast<std::size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            auto const temporary = path + "." + std::to_string(unique) + ".tmp";
+
+            {
+                std::ofstream stream{ temporary, std::ios::binary | std::ios::trunc };
+                uint64_t written{};
+
+                auto write = [&](auto const& records, uint64_t const offset)
+                {
+                    std::array<char, 8> const padding{};
+                    stream.write(padding.data(), static_cast<std::streamsize>(offset - written));
+                    auto const size = records.size() * sizeof(records[0]);
+                    stream.write(reinterpret_cast<char const*>(records.data()), static_cast<std::streamsize>(size));
+                    written = offset + size;
+                };
+
+                snapshot_layout const layout{ header };
+                write(std::array<snapshot_header, 1>{ header }, 0);
+                write(files, layout.files);
+                write(namespaces, layout.namespaces);
+                write(members, layout.members);
+                write(variant_lists, layout.variant_lists);
+                write(variants, layout.variants);
+                write(categories, layout.categories);
+                write(nested, layout.nested);
+                write(index, layout.index);
+                write(nested_index, layout.nested_index);
+                write(strings, layout.strings);
+                write(std::string_view{}, layout.size);
+
+                if (!stream)
+                {
+                    stream.close();
+                    std::error_code error;
+                    std::filesystem::remove(temporary, error);
+                    return false;
+                }
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temporary, path, error);
+
+            if (error)
+            {
+                std::filesystem::remove(temporary, error);
+                return false;
+            }
+
+            return true;
+        }
+
+        std::vector<snapshot_file> files;
+        std::vector<snapshot_namespace> namespaces;
+        std::vector<snapshot_member> members;
+        std::vector<snapshot_variant_list> variant_lists;
+        std::vector<snapshot_variant> variants;
+        std::vector<snapshot_type> categories;
+        std::vector<snapshot_nested> nested;
+        std::vector<snapshot_entry> index;
+        std::vector<snapshot_nested_entry> nested_index;
+        std::string strings;
+
+    private:
+
+        std::string_view string(snapshot_string const& value) const noexcept
+        {
+            return std::string_view{ strings }.substr(value.offset, value.size);
+        }
+
+        static std::size_t capacity(std::size_t const count) noexcept
+        {
+            std::size_t capacity = 16;
+
+            while (capacity < count * 2)
+            {
+                capacity *= 2;
+            }
+
+            return capacity;
+        }
+
+        std::vector<reader::database const*> m_databases;
+    };
+
+    // A mapped snapshot. Every record is checked once when the file is opened, so the accessors below need no
+    // further bounds checks; type lookups probe the mapped index directly.
+    struct snapshot_view
+    {
+        snapshot_view(snapshot_view const&) = delete;
+        snapshot_view& operator=(snapshot_view const&) = delete;
+
+        // Maps the snapshot at path if it exists, was written by this version, describes exactly the given
+        // databases and is internally consistent. Returns null otherwise.
+        static std::unique_ptr<snapshot_view> open(std::string const& path, std::vector<reader::database const*> databases)
+        {
+            std::error_code error;
+
+            if (!std::filesystem::is_regular_file(path, error))
+            {
+                return {};
+            }
+
+            std::unique_ptr<snapshot_view> result;
+
+            try
+            {
+                result.reset(new snapshot_view{ path, std::move(databases) });
+            }
+            catch (std::exception const&)
+            {
+                return {};
+            }
+
+            if (!result->validate())
+            {
+                return {};
+            }
+
+            return result;
+        }
+
+        reader::TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        {
+            auto const entry = find_entry(type_namespace, type_name);
+
+            if (!entry)
+            {
+                return {};
+            }
+
+            if (entry->member != snapshot_none)
+            {
+                return type(members[entry->member].type);
+            }
+
+            return type(variants[variant_lists[entry->variant_list].first].type);
+        }
+
+        // As type_variants::find: the first variant that supports any of the architectures; None selects the first.
+        reader::TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name, reader::Architecture const arches) const noexcept
+        {
+            auto const entry = find_entry(type_namespace, type_name);
+
+            if (!entry)
+            {
+                return {};
+            }
+
+            if (entry->member != snapshot_none)
+            {
+                return type(members[entry->member].type);
+            }
+
+            auto const& list = variant_lists[entry->variant_list];
+
+            for (auto variant = list.first; variant != list.last; ++variant)
+            {
+                if (arches == reader::Architecture::None || (variants[variant].arches & arches))
+                {
+                    return type(variants[variant].type);
+                }
+            }
+
+            return {};
+        }
+
+        reader::TypeDef find_nested(reader::TypeDef const& enclosing_type, std::string_view const& name) const noexcept
+        {
+            auto const file = std::find(m_databases.begin(), m_databases.end(), &enclosing_type.get_database());
+
+            if (file == m_databases.end())
+            {
+                return {};
+            }
+
+            snapshot_type const enclosing{ static_cast<uint32_t>(file - m_databases.begin()), enclosing_type.index() };
+            auto const hash = snapshot_nested_hash(enclosing, name);
+            auto const mask = header->nested_index_capacity - 1;
+
+            for (auto position = hash & mask;; position = (position + 1) & mask)
+            {
+                auto const& entry = nested_index[position];
+
+                if (entry.type.file == snapshot_none)
+                {
+                    return {};
+                }
+
+                if (entry.hash == hash && entry.enclosing_type.file == enclosing.file && entry.enclosing_type.row == enclosing.row && string(entry.name) == name)
+                {
+                    return type(entry.type);
+                }
+            }
+        }
+
+        std::string_view string(snapshot_string const& value) const noexcept
+        {
+            return { strings + value.offset, value.size };
+        }
+
+        reader::TypeDef type(snapshot_type const& value) const noexcept
+        {
+            return m_databases[value.file]->TypeDef[value.row];
+        }
+
+        snapshot_header const* header{};
+        snapshot_namespace const* namespaces{};
+        snapshot_member const* members{};
+        snapshot_variant_list const* variant_lists{};
+        snapshot_variant const* variants{};
+        snapshot_type const* categories{};
+        snapshot_nested const* nested{};
+        snapshot_entry const* index{};
+        snapshot_nested_entry const* nested_index{};
+        char const* strings{};
+
+    private:
+
+        snapshot_view(std::string const& path, std::vector<reader::database const*>&& databases) : m_view{ path }, m_databases{ std::move(databases) }
+        {
+        }
+
+        template <typename T>
+        T const* section(uint64_t const offset) const noexcept
+        {
+            return reinterpret_cast<T const*>(m_view.begin() + offset);
+        }
+
+        bool validate()
+        {
+            if (m_view.size() < sizeof(snapshot_header))
+            {
+                return false;
+            }
+
+            header = section<snapshot_header>(0);
+
+            if (header->magic != snapshot_magic || header->version != snapshot_version || header->files != m_databases.size())
+            {
+                return false;
+            }
+
+            snapshot_layout const layout{ *header };
+
+            if (layout.size > m_view.size())
+            {
+                return false;
+            }
+
+            auto const files = section<snapshot_file>(layout.files);
+            namespaces = section<snapshot_namespace>(layout.namespaces);
+            members = section<snapshot_member>(layout.members);
+            variant_lists = section<snapshot_variant_list>(layout.variant_lists);
+            variants = section<snapshot_variant>(layout.variants);
+            categories = section<snapshot_type>(layout.categories);
+            nested = section<snapshot_nested>(layout.nested);
+            index = section<snapshot_entry>(layout.index);
+            nested_index = section<snapshot_nested_entry>(layout.nested_index);
+            strings = section<char>(layout.strings);
+
+            auto valid_string = [&](snapshot_string const& value)
+            {
+                return uint64_t{ value.offset } + value.size <= header->strings;
+            };
+
+            auto valid_type = [&](snapshot_type const& value)
+            {
+                return value.file < header->files && value.row < m_databases[value.file]->TypeDef.size();
+            };
+
+            auto valid_range = [](uint32_t const first, uint32_t const last, uint32_t const count)
+            {
+                return first <= last && last <= count;
+            };
+
+            auto valid_capacity = [](uint32_t const capacity)
+            {
+                return capacity != 0 && (capacity & (capacity - 1)) == 0;
+            };
+
+            for (uint32_t file = 0; file < header->files; ++file)
+            {
+                if (!valid_string(files[file].path) || string(files[file].path) != m_databases[file]->path() || !snapshot_file_matches(files[file], *m_databases[file]))
+                {
+                    return false;
+                }
+            }
+
+            for (uint32_t ns = 0; ns < header->namespaces; ++ns)
+            {
+                auto const& value = namespaces[ns];
+
+                if (!valid_string(value.name) ||
+                    !valid_range(value.first_member, value.last_member, header->members) ||
+                    !valid_range(value.first_variant_list, value.last_variant_list, header->variant_lists) ||
+                    !std::is_sorted(value.categories.begin(), value.categories.end()) ||
+                    value.categories.back() > header->categories)
+                {
+                    return false;
+                }
+            }
+
+            for (uint32_t member = 0; member < header->members; ++member)
+            {
+                if (!valid_string(members[member].name) || !valid_type(members[member].type))
+                {
+                    return false;
+                }
+            }
+
+            for (uint32_t list = 0; list < header->variant_lists; ++list)
+            {
+                auto const& value = variant_lists[list];
+
+                if (!valid_string(value.name) || !valid_range(value.first, value.last, header->variants) || value.first == value.last)
+                {
+                    return false;
+                }
+            }
+
+            for (uint32_t variant = 0; variant < header->variants; ++variant)
+            {
+                if (!valid_type(variants[variant].type))
+                {
+                    return false;
+                }
+            }
+
+            for (uint32_t category = 0; category < header->categories; ++category)
+            {
+                if (!valid_type(categories[category]))
+                {
+                    return false;
+                }
+            }
+
+            for (uint32_t row = 0; row < header->nested; ++row)
+            {
+                if (!valid_type(nested[row].enclosing_type) || !valid_type(nested[row].nested_type))
+                {
+                    return false;
+                }
+            }
+
+            // Probing stops at the first empty slot, so each table must have one.
+            if (!valid_capacity(header->index_capacity) || !valid_capacity(header->nested_index_capacity))
+            {
+                return false;
+            }
+
+            uint32_t empty{};
+
+            for (uint32_t position = 0; position < header->index_capacity; ++position)
+            {
+                auto const& entry = index[position];
+
+                if (entry.member == snapshot_none && entry.variant_list == snapshot_none)
+                {
+                    ++empty;
+                    continue;
+                }
+
+                if (!valid_string(entry.type_namespace) || !valid_string(entry.name) ||
+                    (entry.member != snapshot_none && entry.member >= header->members) ||
+                    (entry.variant_list != snapshot_none && entry.variant_list >= header->variant_lists))
+                {
+                    return false;
+                }
+            }
+
+            if (!empty)
+            {
+                return false;
+            }
+
+            empty = 0;
+
+            for (uint32_t position = 0; position < header->nested_index_capacity; ++position)
+            {
+                auto const& entry = nested_index[position];
+
+                if (entry.type.file == snapshot_none)
+                {
+                    ++empty;
+                    continue;
+                }
+
+                if (!valid_type(entry.enclosing_type) || !valid_string(entry.name) || !valid_type(entry.type))
+                {
+                    return false;
+                }
+            }
+
+            return empty != 0;
+        }
+
+        snapshot_entry const* find_entry(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        {
+            auto const hash = snapshot_key_hash(type_namespace, type_name);
+            auto const mask = header->index_capacity - 1;
+
+            for (auto position = hash & mask;; position = (position + 1) & mask)
+            {
+                auto const& entry = index[position];
+
+                if (entry.member == snapshot_none && entry.variant_list == snapshot_none)
+                {
+                    return nullptr;
+                }
+
+                if (entry.hash == hash && string(entry.name) == type_name && string(entry.type_namespace) == type_namespace)
+                {
+                    return &entry;
+                }
+            }
+        }
+
+        reader::file_view m_view;
+        std::vector<reader::database const*> m_databases;
+    };
+}
@@ -41,7 +41,7 @@ namespace winmd::reader
             XLANG_ASSERT(data_size == 1 || data_size == 2 || data_size == 4 || data_size == 8);
             XLANG_ASSERT(data_size <= sizeof(T));
 
-            if (row > size())
+            if (m_checked && row >= size())
             {
                 impl::throw_invalid("Invalid row index");
             }
@@ -72,8 +72,96 @@ namespace winmd::reader
             }
         }
 
+        // Calls callback with a std::integral_constant holding the width of column in bytes. Column widths are
+        // fixed once the database is initialized, so a loop over many rows dispatches once and then reads the
+        // column with get_fixed_value, which compiles to a plain load of that width.
+        template <typename F>
+        decltype(auto) visit_column(uint32_t const column, F&& callback) const
+        {
+            switch (m_columns[column].size)
+            {
+            case 1: return callback(std::integral_constant<uint32_t, 1>{});
+            case 2: return callback(std::integral_constant<uint32_t, 2>{});
+            case 4: return callback(std::integral_constant<uint32_t, 4>{});
+            default: return callback(std::integral_constant<uint32_t, 8>{});
+            }
+        }
+
+        // Reads a column known to be Width bytes wide from a row known to be in range.
+        template <typename T, uint32_t Width>
+        T get_fixed_value(uint32_t const row, uint32_t const column) const noexcept
+        {
+            static_assert(std::is_enum_v<T> || std::is_integral_v<T>);
+            static_assert(Width <= sizeof(T) || Width == 8);
+            XLANG_ASSERT(m_columns[column].size == Width);
+            XLANG_ASSERT(row < size());
+
+            using storage = std::conditional_t<Width == 1, uint8_t, std::conditional_t<Width == 2, uint16_t, std::conditional_t<Width == 4, uint32_t, uint64_t>>>;
+            return static_cast<T>(*reinterpret_cast<storage const*>(m_data + row * m_row_size + m_columns[column].offset));
+        }
+
+        // Index of the first row whose column is not less than value, for a table sorted by that column.
+        uint32_t lower_bound_row(uint32_t const column, uint32_t const value) const noexcept
+        {
+            return visit_column(column, [&](auto width)
+            {
+                return partition_rows([&](uint32_t const row) { return get_fixed_value<uint32_t, width>(row, column) < value; });
+            });
+        }
+
+        // Index of the first row whose column is greater than value, for a table sorted by that column.
+        uint32_t upper_bound_row(uint32_t const column, uint32_t const value) const noexcept
+        {
+            return visit_column(column, [&](auto width)
+            {
+                return partition_rows([&](uint32_t const row) { return !(value < get_fixed_value<uint32_t, width>(row, column)); });
+            });
+        }
+
+        std::pair<uint32_t, uint32_t> equal_range_rows(uint32_t const column, uint32_t const value) const noexcept
+        {
+            return visit_column(column, [&](auto width)
+            {
+                auto const first = partition_rows([&](uint32_t const row) { return get_fixed_value<uint32_t, width>(row, column) < value; });
+                uint32_t last = first;
+
+                // Matching runs are short, so a linear scan beats a second binary search.
+                while (last < m_row_count && get_fixed_value<uint32_t, width>(last, column) == value)
+                {
+                    ++last;
+                }
+
+                return std::pair{ first, last };
+            });
+        }
+
     private:
 
+        template <typename Predicate>
+        uint32_t partition_rows(Predicate const& predicate) const noexcept
+        {
+            uint32_t first = 0;
+            uint32_t count = m_row_count;
+
+            while (count > 0)
+            {
+                uint32_t const step = count / 2;
+
+                if (predicate(first + step))
+                {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                {
+                    count = step;
+                }
+            }
+
+            return first;
+        }
+
+
         friend database;
 
         struct column
@@ -88,6 +176,9 @@ namespace winmd::reader
         uint8_t m_row_size{};
         std::array<column, 6> m_columns{};
 
+        // Cleared once the database has proven that every stored index is in range, or is trusted to be.
+        bool m_checked{ true };
+
         void set_row_count(uint32_t const row_count) noexcept
         {
             XLANG_ASSERT(!m_row_count);
@@ -116,13 +207,19 @@ namespace winmd::reader
             if (f) { m_columns[5] = { static_cast<uint8_t>(a + b + c + d + e), f }; }
         }
 
-        void set_data(byte_view& view) noexcept
+        void set_data(byte_view& view)
         {
             XLANG_ASSERT(!m_data);
 
             if (m_row_count)
             {
                 XLANG_ASSERT(m_row_size);
+
+                if (uint64_t{ m_row_count } * m_row_size > view.size())
+                {
+                    impl::throw_invalid("Metadata table extends past the end of the stream");
+                }
+
                 m_data = view.begin();
                 view = view.seek(m_row_count * m_row_size);
             }
@@ -156,6 +253,12 @@ namespace winmd::reader
             return m_value != 0;
         }
 
+        // The encoded value as stored in the table.
+        uint32_t value() const noexcept
+        {
+            return m_value;
+        }
+
         T type() const noexcept
         {
             return static_cast<T>(m_value & ((1 << coded_index_bits_v<T>) - 1));
@@ -25,9 +25,24 @@ namespace winmd::reader
         return get_type_namespace_and_name(type.Extends());
     }
 
-    inline auto extends_type(TypeDef type, std::string_view typeNamespace, std::string_view typeName)
+    inline bool extends_type(TypeDef type, hashed_string const& typeNamespace, hashed_string const& typeName)
     {
-        return get_base_class_namespace_and_name(type) == std::pair(typeNamespace, typeName);
+        auto const extends = type.Extends();
+
+        if (!extends)
+        {
+            return false;
+        }
+        else if (extends.type() == TypeDefOrRef::TypeDef)
+        {
+            return extends.TypeDef().has_name(typeNamespace, typeName);
+        }
+        else if (extends.type() == TypeDefOrRef::TypeRef)
+        {
+            return extends.TypeRef().has_name(typeNamespace, typeName);
+        }
+
+        return false;
     }
 
     inline bool is_nested(TypeDef const& type)
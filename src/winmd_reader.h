@@ -9,12 +9,16 @@
 #include "impl/winmd_reader/table.h"
 #include "impl/winmd_reader/index.h"
 #include "impl/winmd_reader/signature.h"
+#include "impl/winmd_reader/signature_view.h"
 #include "impl/winmd_reader/schema.h"
 #include "impl/winmd_reader/database.h"
+#include "impl/winmd_reader/handle.h"
 #include "impl/winmd_reader/column.h"
 #include "impl/winmd_reader/type_helpers.h"
 #include "impl/winmd_reader/key.h"
+#include "impl/winmd_reader/snapshot.h"
 #include "impl/winmd_reader/cache.h"
 #include "impl/winmd_reader/filter.h"
 #include "impl/winmd_reader/custom_attribute.h"
+#include "impl/winmd_reader/memo.h"
 #include "impl/winmd_reader/helpers.h"
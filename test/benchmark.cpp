@@ -0,0 +1,1045 @@
+#include "pch.h"
+#include <winmd_reader.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "synthetic_winmd.h"
+
+using namespace winmd::reader;
+
+// Benchmarks are hidden from the default run. Use "winmd.exe [benchmark]" to run them. Set WIN32_WINMD_PATH to
+// the Windows.Win32.winmd from the Microsoft.Windows.SDK.Win32Metadata package to measure against the Win32
+// metadata; otherwise the system WinMetadata files are used on Windows and synthetic files everywhere else.
+
+namespace
+{
+    std::vector<std::string> get_benchmark_files()
+    {
+        std::vector<std::string> files;
+
+        if (auto const win32 = std::getenv("WIN32_WINMD_PATH"))
+        {
+            files.push_back(win32);
+            return files;
+        }
+
+#ifdef _WIN32
+        std::array<char, 260> local{};
+
+#ifdef _WIN64
+        ExpandEnvironmentStringsA("%windir%\\System32\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#else
+        ExpandEnvironmentStringsA("%windir%\\SysNative\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#endif
+
+        for (auto&& file : std::filesystem::directory_iterator(local.data()))
+        {
+            if (file.path().extension() == ".winmd")
+            {
+                files.push_back(file.path().string());
+            }
+        }
+#else
+        winmd::test::synthetic_options options;
+        options.namespaces = 64;
+        options.types_per_namespace = 128;
+        options.methods_per_namespace = 64;
+        options.nested_per_type = 16;
+        auto const directory = std::filesystem::temp_directory_path();
+        files.push_back(winmd::test::write_synthetic_winmd(directory / "winmd_benchmark_synthetic.winmd", options));
+        options.referenced_assembly = options.assembly_name;
+        options.assembly_name = "Referencing";
+        files.push_back(winmd::test::write_synthetic_winmd(directory / "winmd_benchmark_referencing.winmd", options));
+#endif
+
+        return files;
+    }
+
+    template <typename F>
+    double measure(std::string_view const& name, std::size_t const operations, F&& callback)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        callback();
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        auto const rate = operations / elapsed.count();
+        std::cout << name << ": " << static_cast<uint64_t>(rate) << " per second" << std::endl;
+        return rate;
+    }
+}
+
+TEST_CASE("benchmark_cache_find", "[.][benchmark]")
+{
+    cache const c(get_benchmark_files());
+    std::vector<std::pair<std::string_view, std::string_view>> keys;
+
+    for (auto&&[ns, members] : c.namespaces())
+    {
+        for (auto&&[name, type] : members.types)
+        {
+            keys.emplace_back(ns, name);
+        }
+    }
+
+    // Visit the keys in a fixed but scattered order so neither structure benefits from sorted access.
+    std::shuffle(keys.begin(), keys.end(), std::mt19937{ 42 });
+    uint32_t const repeat = 20;
+    std::size_t found_map{};
+    std::size_t found_index{};
+
+    measure("std::map lookups", keys.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&&[ns, name] : keys)
+            {
+                auto const members = c.namespaces().find(ns);
+                found_map += members != c.namespaces().end() && members->second.types.find(name) != members->second.types.end();
+            }
+        }
+    });
+
+    measure("cache::find lookups", keys.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&&[ns, name] : keys)
+            {
+                found_index += static_cast<bool>(c.find(ns, name));
+            }
+        }
+    });
+
+    REQUIRE(found_map == keys.size() * repeat);
+    REQUIRE(found_index == found_map);
+}
+
+TEST_CASE("benchmark_nested_find", "[.][benchmark]")
+{
+    cache const c(get_benchmark_files());
+    std::vector<std::pair<TypeDef, std::string_view>> keys;
+
+    for (auto&& db : c.databases())
+    {
+        for (auto&& row : db.NestedClass)
+        {
+            keys.emplace_back(row.EnclosingType(), row.NestedType().TypeName());
+        }
+    }
+
+    std::shuffle(keys.begin(), keys.end(), std::mt19937{ 42 });
+    uint32_t const repeat = 20;
+    std::size_t found_linear{};
+    std::size_t found_hashed{};
+
+    // Baseline: the linear scan of the enclosing type's nested types that find(TypeRef) used to do.
+    measure("nested type lookups by linear scan", keys.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&&[enclosing, name] : keys)
+            {
+                auto const& nested = c.nested_types(enclosing);
+                found_linear += std::any_of(nested.begin(), nested.end(), [name = name](TypeDef const& type)
+                {
+                    return type.TypeName() == name;
+                });
+            }
+        }
+    });
+
+    measure("nested type lookups by find_nested", keys.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&&[enclosing, name] : keys)
+            {
+                found_hashed += static_cast<bool>(c.find_nested(enclosing, name));
+            }
+        }
+    });
+
+    REQUIRE(found_hashed == found_linear);
+}
+
+TEST_CASE("benchmark_filter", "[.][benchmark]")
+{
+    auto const files = get_benchmark_files();
+    cache const c(files);
+    std::vector<std::string> names;
+    std::vector<std::string> include;
+    std::vector<std::string> exclude;
+
+    // Hundreds of rules, as from a response file: half of the namespaces in, and a few types of those out.
+    for (auto&&[ns, members] : c.namespaces())
+    {
+        for (auto&&[name, type] : members.types)
+        {
+            names.push_back(std::string{ ns } + "." + std::string{ name });
+        }
+
+        auto& rules = names.size() % 2 ? include : exclude;
+        rules.emplace_back(ns);
+        include.push_back(std::string{ ns } + ".Missing" + std::to_string(include.size()));
+        exclude.push_back(names.back());
+    }
+
+    std::vector<std::pair<std::string, bool>> linear;
+
+    for (auto&& rule : include)
+    {
+        linear.emplace_back(rule, true);
+    }
+
+    for (auto&& rule : exclude)
+    {
+        linear.emplace_back(rule, false);
+    }
+
+    std::sort(linear.begin(), linear.end(), [](auto const& lhs, auto const& rhs)
+    {
+        return std::pair{ lhs.first.size(), !lhs.second } > std::pair{ rhs.first.size(), !rhs.second };
+    });
+
+    std::cout << linear.size() << " rules" << std::endl;
+    filter const f{ include, exclude };
+    uint32_t const repeat = 10;
+    std::size_t included_linear{};
+    std::size_t included_trie{};
+
+    // Baseline: the sorted rule list that the filter used to test one rule at a time.
+    measure("filter includes by linear rules", names.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& name : names)
+            {
+                included_linear += std::find_if(linear.begin(), linear.end(), [&](auto&& rule)
+                {
+                    return winmd::impl::starts_with(name, rule.first);
+                })->second;
+            }
+        }
+    });
+
+    measure("filter includes by trie", names.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& name : names)
+            {
+                included_trie += f.includes(name);
+            }
+        }
+    });
+
+    REQUIRE(included_trie == included_linear);
+
+    measure("filtered cache builds, per-type callback", 1, [&]
+    {
+        cache const filtered(files, [&](TypeDef const& type) { return f.includes(type); });
+    });
+
+    measure("filtered cache builds, compiled filter", 1, [&]
+    {
+        cache const filtered(files, f);
+    });
+}
+
+TEST_CASE("benchmark_type_ref_resolution", "[.][benchmark]")
+{
+    cache c(get_benchmark_files());
+    std::size_t refs{};
+
+    for (auto&& db : c.databases())
+    {
+        refs += db.TypeRef.size();
+    }
+
+    uint32_t const repeat = 20;
+    std::size_t found{};
+    std::size_t found_resolved{};
+
+    auto resolve_all = [&](std::size_t& count)
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : c.databases())
+            {
+                for (auto&& type : db.TypeRef)
+                {
+                    count += static_cast<bool>(find(type, Architecture::X64));
+                }
+            }
+        }
+    };
+
+    measure("TypeRef finds", refs * repeat, [&] { resolve_all(found); });
+
+    std::size_t unresolved{};
+    measure("resolve_type_refs rows", refs, [&] { unresolved = c.resolve_type_refs(Architecture::X64); });
+    std::cout << "unresolved TypeRef rows: " << unresolved << " of " << refs << std::endl;
+
+    measure("TypeRef finds after resolve_type_refs", refs * repeat, [&] { resolve_all(found_resolved); });
+    REQUIRE(found_resolved == found);
+    REQUIRE(refs * repeat - found == unresolved * repeat);
+}
+
+TEST_CASE("benchmark_attribute_lookup", "[.][benchmark]")
+{
+    cache const c(get_benchmark_files());
+    std::array<std::pair<std::string_view, std::string_view>, 4> const attributes
+    { {
+        { "Windows.Win32.Foundation.Metadata", "SupportedArchitectureAttribute" },
+        { "Windows.Win32.Foundation.Metadata", "NativeTypedefAttribute" },
+        { "Windows.Foundation.Metadata", "GuidAttribute" },
+        { "Windows.Foundation.Metadata", "ContractVersionAttribute" },
+    } };
+
+    std::size_t types{};
+
+    for (auto&& db : c.databases())
+    {
+        types += db.TypeDef.size();
+    }
+
+    std::size_t found_names{};
+    std::size_t found_ids{};
+
+    // Baseline: resolve the namespace and name of every attribute and compare strings.
+    measure("attribute lookups by name", types * attributes.size(), [&]
+    {
+        for (auto&& db : c.databases())
+        {
+            for (auto&& type : db.TypeDef)
+            {
+                for (auto&&[type_namespace, type_name] : attributes)
+                {
+                    for (auto&& attribute : type.CustomAttribute())
+                    {
+                        auto const pair = attribute.TypeNamespaceAndName();
+
+                        if (pair.first == type_namespace && pair.second == type_name)
+                        {
+                            ++found_names;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    measure("attribute lookups by id", types * attributes.size(), [&]
+    {
+        for (auto&& db : c.databases())
+        {
+            std::array<attribute_type_id, attributes.size()> ids;
+
+            for (std::size_t i = 0; i < attributes.size(); ++i)
+            {
+                ids[i] = db.find_attribute_type(attributes[i].first, attributes[i].second);
+            }
+
+            for (auto&& type : db.TypeDef)
+            {
+                for (auto&& id : ids)
+                {
+                    found_ids += has_attribute(type, id);
+                }
+            }
+        }
+    });
+
+    REQUIRE(found_ids == found_names);
+}
+
+TEST_CASE("benchmark_attribute_values", "[.][benchmark]")
+{
+    auto const files = get_benchmark_files();
+    cache c(files);
+    std::size_t attributes{};
+    std::vector<TypeDef> enums;
+
+    for (auto&& db : c.databases())
+    {
+        attributes += db.CustomAttribute.size();
+
+        for (auto&& type : db.TypeDef)
+        {
+            if (type.is_enum())
+            {
+                enums.push_back(type);
+            }
+        }
+    }
+
+    std::size_t decoded{};
+
+    auto decode_all = [&](database const& db)
+    {
+        for (auto&& attribute : db.CustomAttribute)
+        {
+            decoded += attribute.Value().FixedArgs().size();
+        }
+    };
+
+    // Baseline: the scan of the enum's fields that every enum argument used to repeat.
+    std::size_t scanned{};
+
+    measure("enum underlying types by field scan", enums.size(), [&]
+    {
+        for (auto&& type : enums)
+        {
+            for (auto&& field : type.FieldList())
+            {
+                if (!field.Flags().Literal() && !field.Flags().Static())
+                {
+                    scanned += static_cast<std::size_t>(std::get<ElementType>(field.Signature().Type().Type()));
+                }
+            }
+        }
+    });
+
+    std::size_t memoized{};
+
+    for (auto&& type : enums)
+    {
+        type.get_database().enum_underlying_type(type);
+    }
+
+    measure("enum underlying types memoized", enums.size(), [&]
+    {
+        for (auto&& type : enums)
+        {
+            memoized += static_cast<std::size_t>(type.get_database().enum_underlying_type(type));
+        }
+    });
+
+    REQUIRE(memoized == scanned);
+
+    measure("attribute values through the cache", attributes, [&]
+    {
+        for (auto&& db : c.databases())
+        {
+            decode_all(db);
+        }
+    });
+
+    c.resolve_type_refs(Architecture::All);
+
+    measure("attribute values with resolved type refs", attributes, [&]
+    {
+        for (auto&& db : c.databases())
+        {
+            decode_all(db);
+        }
+    });
+
+    // Only the first file is opened without a cache, since references into other files cannot resolve there.
+    database const db{ files.front() };
+    decode_all(db);
+
+    measure("attribute values without a cache", db.CustomAttribute.size(), [&]
+    {
+        decode_all(db);
+    });
+
+    REQUIRE(decoded > 0);
+}
+
+TEST_CASE("benchmark_method_signature", "[.][benchmark]")
+{
+    cache const c(get_benchmark_files());
+    std::size_t methods{};
+
+    for (auto&& db : c.databases())
+    {
+        methods += db.MethodDef.size();
+    }
+
+    uint32_t const repeat = 5;
+    std::size_t eager{};
+    std::size_t lazy{};
+
+    measure("eager MethodDefSig decodes", methods * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : c.databases())
+            {
+                for (auto&& method : db.MethodDef)
+                {
+                    auto const signature = method.Signature();
+                    auto const[first, last] = signature.Params();
+
+                    for (auto param = first; param != last; ++param)
+                    {
+                        auto const[cmod_first, cmod_last] = param->CustomMod();
+                        eager += static_cast<std::size_t>(param->Type().element_type()) + param->Type().ptr_count() + (cmod_last - cmod_first);
+                    }
+                }
+            }
+        }
+    });
+
+    std::size_t arena_total{};
+
+    measure("eager MethodDefSig decodes into an arena", methods * repeat, [&]
+    {
+        std::pmr::monotonic_buffer_resource arena;
+
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : c.databases())
+            {
+                for (auto&& method : db.MethodDef)
+                {
+                    auto const signature = method.Signature(&arena);
+                    auto const[first, last] = signature.Params();
+
+                    for (auto param = first; param != last; ++param)
+                    {
+                        auto const[cmod_first, cmod_last] = param->CustomMod();
+                        arena_total += static_cast<std::size_t>(param->Type().element_type()) + param->Type().ptr_count() + (cmod_last - cmod_first);
+                    }
+                }
+            }
+
+            arena.release();
+        }
+    });
+
+    measure("MethodDefSigView decodes", methods * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : c.databases())
+            {
+                for (auto&& method : db.MethodDef)
+                {
+                    for (auto&& param : method.SignatureView().Params())
+                    {
+                        lazy += static_cast<std::size_t>(param.Type().element_type()) + param.Type().ptr_count() + param.CustomMod().size();
+                    }
+                }
+            }
+        }
+    });
+
+    REQUIRE(arena_total == eager);
+    REQUIRE(lazy == eager);
+}
+
+TEST_CASE("benchmark_table_columns", "[.][benchmark]")
+{
+    cache const c(get_benchmark_files());
+    std::size_t cells{};
+
+    for (auto&& db : c.databases())
+    {
+        for (auto&& table : db.tables())
+        {
+            for (uint32_t column = 0; column < 6 && table->column_size(column); ++column)
+            {
+                cells += table->size();
+            }
+        }
+    }
+
+    uint32_t const repeat = 20;
+    uint64_t checked{};
+    uint64_t fixed{};
+
+    measure("get_value column reads", cells * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : c.databases())
+            {
+                for (auto&& table : db.tables())
+                {
+                    for (uint32_t column = 0; column < 6 && table->column_size(column); ++column)
+                    {
+                        for (uint32_t row = 0; row < table->size(); ++row)
+                        {
+                            checked += table->get_value<uint64_t>(row, column);
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    measure("get_fixed_value column reads", cells * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : c.databases())
+            {
+                for (auto&& table : db.tables())
+                {
+                    for (uint32_t column = 0; column < 6 && table->column_size(column); ++column)
+                    {
+                        table->visit_column(column, [&](auto width)
+                        {
+                            for (uint32_t row = 0; row < table->size(); ++row)
+                            {
+                                fixed += table->get_fixed_value<uint64_t, width>(row, column);
+                            }
+                        });
+                    }
+                }
+            }
+        }
+    });
+
+    REQUIRE(fixed == checked);
+}
+
+TEST_CASE("benchmark_open_modes", "[.][benchmark]")
+{
+    auto const files = get_benchmark_files();
+
+    // Reads every name and signature blob the way a projection generator walks the metadata.
+    auto scan = [](database const& db)
+    {
+        std::size_t total{};
+
+        for (auto&& type : db.TypeDef)
+        {
+            total += type.TypeName().size() + type.TypeNamespace().size();
+
+            for (auto&& field : type.FieldList())
+            {
+                total += field.Name().size() + field.Signature().Type().is_szarray();
+            }
+
+            for (auto&& method : type.MethodList())
+            {
+                total += method.Name().size() + method.SignatureView().GenericParamCount();
+
+                for (auto&& param : method.ParamList())
+                {
+                    total += param.Name().size();
+                }
+            }
+        }
+
+        for (auto&& member : db.MemberRef)
+        {
+            total += member.Name().size() + member.Class().index();
+        }
+
+        return total;
+    };
+
+    std::size_t rows{};
+
+    for (auto&& file : files)
+    {
+        database const db{ file };
+        rows += db.TypeDef.size() + db.Field.size() + db.MethodDef.size() + db.Param.size() + db.MemberRef.size();
+    }
+
+    uint32_t const repeat = 20;
+    std::size_t expected{};
+
+    for (auto&& mode : { open_mode::checked, open_mode::validated, open_mode::trusted })
+    {
+        auto const name = mode == open_mode::checked ? "checked" : mode == open_mode::validated ? "validated" : "trusted";
+        std::list<database> databases;
+
+        measure(std::string{ name } + " open", files.size() * repeat, [&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                databases.clear();
+
+                for (auto&& file : files)
+                {
+                    databases.emplace_back(file, nullptr, mode);
+                }
+            }
+        });
+
+        std::size_t total{};
+
+        measure(std::string{ name } + " full table scan rows", rows * repeat, [&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&& db : databases)
+                {
+                    total += scan(db);
+                }
+            }
+        });
+
+        if (!expected)
+        {
+            expected = total;
+        }
+
+        REQUIRE(total == expected);
+    }
+}
+
+TEST_CASE("benchmark_string_table", "[.][benchmark]")
+{
+    auto const files = get_benchmark_files();
+    std::list<database> plain;
+    std::list<database> indexed;
+    std::size_t strings{};
+
+    for (auto&& file : files)
+    {
+        plain.emplace_back(file);
+        indexed.emplace_back(file);
+        strings += 2 * plain.back().TypeDef.size() + plain.back().Field.size() + plain.back().MethodDef.size() + plain.back().Param.size();
+    }
+
+    measure("string table builds", files.size(), [&]
+    {
+        for (auto&& db : indexed)
+        {
+            db.enable_string_table();
+        }
+    });
+
+    uint32_t const repeat = 20;
+
+    auto read_names = [&](std::list<database> const& databases)
+    {
+        std::size_t total{};
+
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : databases)
+            {
+                for (auto&& type : db.TypeDef)
+                {
+                    total += type.TypeDisplayName().size() + type.TypeNamespace().size();
+                }
+
+                for (auto&& field : db.Field)
+                {
+                    total += field.Name().size();
+                }
+
+                for (auto&& method : db.MethodDef)
+                {
+                    total += method.Name().size();
+                }
+
+                for (auto&& param : db.Param)
+                {
+                    total += param.Name().size();
+                }
+            }
+        }
+
+        return total;
+    };
+
+    // The comparisons get_category makes for every type. Base classes share their namespace with these names and
+    // often their length, and most types extend one of them.
+    auto compare_names = [&](std::list<database> const& databases)
+    {
+        std::size_t total{};
+
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& db : databases)
+            {
+                for (auto&& type : db.TypeDef)
+                {
+                    total += extends_type(type, "System", "ValueType") + extends_type(type, "System", "Attribute");
+                }
+            }
+        }
+
+        return total;
+    };
+
+    std::size_t plain_total{};
+    std::size_t indexed_total{};
+    measure("get_string with terminator scan", strings * repeat, [&] { plain_total = read_names(plain); });
+    measure("get_string with string table", strings * repeat, [&] { indexed_total = read_names(indexed); });
+    REQUIRE(plain_total == indexed_total);
+
+    std::size_t types{};
+
+    for (auto&& db : plain)
+    {
+        types += 2 * db.TypeDef.size();
+    }
+
+    measure("extends_type without string table", types * repeat, [&] { plain_total = compare_names(plain); });
+    measure("extends_type with string table", types * repeat, [&] { indexed_total = compare_names(indexed); });
+    REQUIRE(plain_total == indexed_total);
+}
+
+TEST_CASE("benchmark_simd_kernels", "[.][benchmark]")
+{
+    using winmd::impl::simd_level;
+
+    // A 16 MB heap of identifier-like strings, several times larger than the Win32 metadata #Strings heap.
+    std::mt19937 random{ 42 };
+    std::vector<uint8_t> heap;
+
+    while (heap.size() < 16 * 1024 * 1024)
+    {
+        auto const length = 1 + random() % 48;
+
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            heap.push_back(static_cast<uint8_t>('A' + random() % 26));
+        }
+
+        heap.push_back(0);
+    }
+
+    uint32_t const repeat = 10;
+    std::size_t expected{};
+
+    measure("memchr terminator scan bytes", heap.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            expected = 0;
+
+            for (auto position = heap.data(), last = heap.data() + heap.size(); position != last; ++position)
+            {
+                position = static_cast<uint8_t*>(std::memchr(position, 0, last - position));
+                ++expected;
+            }
+        }
+    });
+
+    std::vector<simd_level> levels{ simd_level::scalar, winmd::impl::supported_simd_level() };
+
+    if (levels.back() == simd_level::avx2)
+    {
+        levels.insert(levels.begin() + 1, simd_level::sse2);
+    }
+
+    std::vector<uint32_t> terminators;
+
+    for (auto level : levels)
+    {
+        char const* const level_names[] = { "scalar", "sse2", "avx2", "neon" };
+
+        measure(std::string{ level_names[static_cast<int>(level)] } + " find_zero_bytes bytes", heap.size() * repeat, [&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                terminators.clear();
+                winmd::impl::find_zero_bytes(heap.data(), heap.data() + heap.size(), terminators, level);
+            }
+        });
+
+        REQUIRE(terminators.size() == expected);
+    }
+
+    // Compare each string with a copy of itself. Lengths vary from one comparison to the next, the worst case for
+    // the inline comparison, whose path depends on the length.
+    std::vector<char> const copy(heap.begin(), heap.end());
+    std::vector<std::pair<std::string_view, std::string_view>> pairs;
+    uint32_t start{};
+
+    for (auto terminator : terminators)
+    {
+        pairs.emplace_back(std::string_view{ reinterpret_cast<char const*>(heap.data()) + start, terminator - start }, std::string_view{ copy.data() + start, terminator - start });
+        start = terminator + 1;
+    }
+
+    std::size_t equal{};
+    std::size_t matched{};
+
+    measure("string_view operator== bytes", heap.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& [lhs, rhs] : pairs)
+            {
+                equal += lhs == rhs;
+            }
+        }
+    });
+
+    measure("impl::equal bytes", heap.size() * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            for (auto&& [lhs, rhs] : pairs)
+            {
+                matched += winmd::impl::equal(lhs, rhs);
+            }
+        }
+    });
+
+    REQUIRE(equal == matched);
+
+    // A filter rule or a name passed to has_name has the same length on every comparison.
+    for (std::size_t length : { 4, 12, 24 })
+    {
+        equal = 0;
+        matched = 0;
+        std::vector<std::pair<std::string_view, std::string_view>> prefixes;
+
+        for (auto&& [lhs, rhs] : pairs)
+        {
+            if (lhs.size() >= length)
+            {
+                prefixes.emplace_back(lhs, rhs.substr(0, length));
+            }
+        }
+
+        measure("string_view::compare " + std::to_string(length) + " byte prefixes", prefixes.size() * repeat, [&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&& [value, prefix] : prefixes)
+                {
+                    equal += 0 == value.compare(0, prefix.size(), prefix);
+                }
+            }
+        });
+
+        measure("impl::starts_with " + std::to_string(length) + " byte prefixes", prefixes.size() * repeat, [&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&& [value, prefix] : prefixes)
+                {
+                    matched += winmd::impl::starts_with(value, prefix);
+                }
+            }
+        });
+
+        REQUIRE(equal == matched);
+    }
+}
+
+TEST_CASE("benchmark_compressed_integers", "[.][benchmark]")
+{
+    // The decoder signatures used before: a branch per encoding length and a checked seek per value.
+    auto legacy = [](byte_view& cursor)
+    {
+        auto data = cursor.begin();
+        uint32_t value;
+        uint32_t length;
+
+        if ((*data & 0x80) == 0x00)
+        {
+            length = 1;
+            value = *data;
+        }
+        else if ((*data & 0xc0) == 0x80)
+        {
+            length = 2;
+            value = (*data++ & 0x3f) << 8;
+            value |= *data;
+        }
+        else if ((*data & 0xe0) == 0xc0)
+        {
+            length = 4;
+            value = (*data++ & 0x1f) << 24;
+            value |= *data++ << 16;
+            value |= *data++ << 8;
+            value |= *data;
+        }
+        else
+        {
+            winmd::impl::throw_invalid("Invalid compressed integer in blob");
+        }
+
+        cursor = cursor.seek(length);
+        return value;
+    };
+
+    // Mostly one-byte values with some two- and four-byte ones, in the proportions of signature blobs, where
+    // element types, counts and most coded indexes fit in a byte.
+    std::mt19937 random{ 7 };
+    std::vector<uint8_t> bytes;
+    std::size_t count{};
+
+    while (bytes.size() < 4 * 1024 * 1024)
+    {
+        auto const kind = random() % 16;
+        ++count;
+
+        if (kind < 12)
+        {
+            bytes.push_back(static_cast<uint8_t>(random() % 0x80));
+        }
+        else if (kind < 15)
+        {
+            bytes.push_back(static_cast<uint8_t>(0x80 | random() % 0x40));
+            bytes.push_back(static_cast<uint8_t>(random()));
+        }
+        else
+        {
+            bytes.push_back(static_cast<uint8_t>(0xc0 | random() % 0x20));
+            bytes.push_back(static_cast<uint8_t>(random()));
+            bytes.push_back(static_cast<uint8_t>(random()));
+            bytes.push_back(static_cast<uint8_t>(random()));
+        }
+    }
+
+    uint32_t const repeat = 10;
+    uint64_t expected{};
+    uint64_t single{};
+    uint64_t batched{};
+
+    measure("legacy uncompress_unsigned values", count * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            byte_view cursor{ bytes.data(), bytes.data() + bytes.size() };
+
+            while (cursor.size())
+            {
+                expected += legacy(cursor);
+            }
+        }
+    });
+
+    measure("uncompress_unsigned values", count * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            byte_view cursor{ bytes.data(), bytes.data() + bytes.size() };
+
+            while (cursor.size())
+            {
+                single += uncompress_unsigned(cursor);
+            }
+        }
+    });
+
+    measure("uncompress_unsigned runs of 8 values", count * repeat, [&]
+    {
+        for (uint32_t i = 0; i < repeat; ++i)
+        {
+            byte_view cursor{ bytes.data(), bytes.data() + bytes.size() };
+            std::size_t remaining = count;
+
+            while (remaining)
+            {
+                std::array<uint32_t, 8> values;
+                auto const run = static_cast<uint32_t>(std::min<std::size_t>(remaining, values.size()));
+                uncompress_unsigned(cursor, values.data(), run);
+                remaining -= run;
+
+                for (uint32_t index = 0; index < run; ++index)
+                {
+                    batched += values[index];
+                }
+            }
+        }
+    });
+
+    REQUIRE(single == expected);
+    REQUIRE(batched == expected);
+}
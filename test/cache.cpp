@@ -113,7 +113,7 @@ bool caches_equal(cache const& lhs, cache const& rhs)
         return lhs.TypeName() == rhs.TypeName() && lhs.TypeNamespace() == rhs.TypeNamespace();
     };
 
-    auto compare_members = [compare_typedef_names](std::vector<TypeDef> const& lhs, std::vector<TypeDef> const& rhs)
+    auto compare_members = [compare_typedef_names](std::vector<type_handle> const& lhs, std::vector<type_handle> const& rhs)
     {
         return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), compare_typedef_names);
     };
@@ -184,3 +184,133 @@ TEST_CASE("cache_filter")
         REQUIRE(!filter_hresult.find(type_namespace, type_name));
     }
 }
+
+TEST_CASE("cache_parallel")
+{
+    std::vector<std::string> files;
+
+    for (auto&& file : std::filesystem::directory_iterator(get_local_winmd_path()))
+    {
+        if (file.path().extension() == ".winmd")
+        {
+            files.push_back(file.path().string());
+        }
+    }
+
+    cache const serial(files);
+    cache const parallel(files, cache::parallel_load{ 4 });
+
+    REQUIRE(caches_equal(serial, parallel));
+    REQUIRE(serial.databases().size() == parallel.databases().size());
+
+    auto db = parallel.databases().begin();
+    for (auto&& file : files)
+    {
+        REQUIRE(db->path() == file);
+        ++db;
+    }
+
+    for (auto&&[ns, members] : serial.namespaces())
+    {
+        for (auto&&[name, type] : members.types)
+        {
+            auto const found = parallel.find(ns, name);
+            REQUIRE(found);
+            REQUIRE(found.get_database().path() == type->get_database().path());
+            REQUIRE(found.index() == type.index());
+        }
+    }
+}
+
+TEST_CASE("cache_memory_resource")
+{
+    std::filesystem::path winmd_dir = get_local_winmd_path();
+    auto file_path = winmd_dir;
+    file_path.append("Windows.Foundation.winmd");
+
+    cache c(file_path.string());
+    auto const& db = c.databases().front();
+
+    // Any allocation that bypasses the arena fails while the null resource is the default.
+    std::pmr::monotonic_buffer_resource arena;
+    std::size_t params{};
+    std::size_t args{};
+    bool default_used{};
+    auto const previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+    try
+    {
+        for (auto&& method : db.MethodDef)
+        {
+            auto const signature = method.Signature(&arena);
+            params += signature.Params().second - signature.Params().first;
+        }
+
+        for (auto&& attribute : db.CustomAttribute)
+        {
+            args += attribute.Value(&arena).FixedArgs().size();
+        }
+    }
+    catch (std::bad_alloc const&)
+    {
+        default_used = true;
+    }
+
+    std::pmr::set_default_resource(previous);
+    REQUIRE(!default_used);
+    REQUIRE(params > 0);
+    REQUIRE(args > 0);
+}
+
+TEST_CASE("cache_memo")
+{
+    std::filesystem::path winmd_dir = get_local_winmd_path();
+    auto file_path = winmd_dir;
+    file_path.append("Windows.Foundation.winmd");
+
+    cache c(file_path.string());
+    auto const& db = c.databases().front();
+    REQUIRE(!db.memo());
+
+    c.enable_memo(64 * 1024 * 1024);
+    REQUIRE(db.memo());
+
+    for (auto&& method : db.MethodDef)
+    {
+        auto const first = memoized_signature(method);
+        auto const second = memoized_signature(method);
+        REQUIRE(first == second);
+        REQUIRE(first->Params().second - first->Params().first == method.Signature().Params().second - method.Signature().Params().first);
+    }
+
+    for (auto&& attribute : db.CustomAttribute)
+    {
+        REQUIRE(memoized_value(attribute) == memoized_value(attribute));
+    }
+
+    auto const stats = db.memo()->get_statistics();
+    REQUIRE(stats.misses > 0);
+    REQUIRE(stats.hits >= db.MethodDef.size() + db.CustomAttribute.size());
+    REQUIRE(stats.evictions == 0);
+    REQUIRE(stats.entries > 0);
+    REQUIRE(stats.bytes > 0);
+
+    // A budget too small for more than a handful of entries evicts, but results stay valid while held.
+    file_path = winmd_dir;
+    file_path.append("Windows.Data.winmd");
+    cache small(file_path.string());
+    small.enable_memo(1024);
+    auto const& small_db = small.databases().front();
+    std::vector<std::shared_ptr<MethodDefSig const>> held;
+
+    for (auto&& method : small_db.MethodDef)
+    {
+        held.push_back(memoized_signature(method));
+    }
+
+    auto const small_stats = small_db.memo()->get_statistics();
+    REQUIRE(small_stats.evictions > 0);
+    REQUIRE(small_stats.bytes <= 1024);
+    auto const first_method = small_db.MethodDef.begin().Signature();
+    REQUIRE(held.front()->Params().second - held.front()->Params().first == first_method.Params().second - first_method.Params().first);
+}
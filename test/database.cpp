@@ -38,3 +38,122 @@ TEST_CASE("database")
     MethodDef method = methods.first;
     REQUIRE(method.Name() == "ToString");
 }
+
+TEST_CASE("database_type_name")
+{
+    std::array<char, 260> local{};
+
+#ifdef _WIN64
+    ExpandEnvironmentStringsA("%windir%\\System32\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#else
+    ExpandEnvironmentStringsA("%windir%\\SysNative\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#endif
+
+    std::filesystem::path path = local.data();
+    path.append("Windows.Foundation.winmd");
+    database db(path.string());
+
+    // Names are computed once per row and owned by the database, so copies of a row share the same storage.
+    for (auto&& type : db.TypeDef)
+    {
+        TypeDef const copy = type;
+        REQUIRE(copy.TypeName().data() == type.TypeName().data());
+        REQUIRE(type.TypeName() == type.TypeDisplayName());
+    }
+
+    for (auto&& type : db.TypeRef)
+    {
+        REQUIRE(db.TypeRef[type.index()].TypeName().data() == type.TypeName().data());
+    }
+}
+
+TEST_CASE("database_attribute_type")
+{
+    std::array<char, 260> local{};
+
+#ifdef _WIN64
+    ExpandEnvironmentStringsA("%windir%\\System32\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#else
+    ExpandEnvironmentStringsA("%windir%\\SysNative\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#endif
+
+    std::filesystem::path path = local.data();
+    path.append("Windows.Foundation.winmd");
+    database db(path.string());
+
+    auto const guid = db.find_attribute_type("Windows.Foundation.Metadata", "GuidAttribute");
+    REQUIRE(guid);
+    REQUIRE(!db.find_attribute_type("Windows.Foundation.Metadata", "NoSuchAttribute"));
+
+    for (auto&& type : db.TypeDef)
+    {
+        for (auto&& attribute : type.CustomAttribute())
+        {
+            auto const pair = attribute.TypeNamespaceAndName();
+            REQUIRE((db.attribute_type(attribute) == guid) == (pair.first == "Windows.Foundation.Metadata" && pair.second == "GuidAttribute"));
+        }
+
+        if (type.Flags().Semantics() == TypeSemantics::Interface)
+        {
+            REQUIRE(has_attribute(type, guid));
+        }
+    }
+}
+
+TEST_CASE("database_signature_view")
+{
+    std::array<char, 260> local{};
+
+#ifdef _WIN64
+    ExpandEnvironmentStringsA("%windir%\\System32\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#else
+    ExpandEnvironmentStringsA("%windir%\\SysNative\\WinMetadata", local.data(), static_cast<uint32_t>(local.size()));
+#endif
+
+    std::filesystem::path path = local.data();
+    path.append("Windows.Foundation.winmd");
+    database db(path.string());
+
+    auto same_type = [](TypeSig const& eager, TypeSigView const& lazy, auto const& recurse) -> void
+    {
+        REQUIRE(eager.element_type() == lazy.element_type());
+        REQUIRE(eager.is_szarray() == lazy.is_szarray());
+        REQUIRE(eager.ptr_count() == lazy.ptr_count());
+        REQUIRE(eager.Type().index() == lazy.Type().index());
+
+        if (auto generic = std::get_if<GenericTypeInstSig>(&eager.Type()))
+        {
+            auto const& view = std::get<GenericTypeInstSigView>(lazy.Type());
+            REQUIRE(generic->GenericType() == view.GenericType());
+            REQUIRE(generic->GenericArgCount() == view.GenericArgCount());
+            auto arg = generic->GenericArgs().first;
+
+            for (auto&& view_arg : view.GenericArgs())
+            {
+                recurse(*arg++, view_arg, recurse);
+            }
+        }
+    };
+
+    for (auto&& method : db.MethodDef)
+    {
+        auto const eager = method.Signature();
+        auto const lazy = method.SignatureView();
+        REQUIRE(static_cast<bool>(eager.ReturnType()) == static_cast<bool>(lazy.ReturnType()));
+
+        if (eager.ReturnType())
+        {
+            same_type(eager.ReturnType().Type(), lazy.ReturnType().Type(), same_type);
+        }
+
+        auto[first, last] = eager.Params();
+        REQUIRE(static_cast<std::size_t>(last - first) == lazy.Params().size());
+
+        for (auto&& param : lazy.Params())
+        {
+            REQUIRE(first->ByRef() == param.ByRef());
+            same_type(first->Type(), param.Type(), same_type);
+            ++first;
+        }
+    }
+}
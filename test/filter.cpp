@@ -1,5 +1,6 @@
 #include "pch.h"
 #include <winmd_reader.h>
+#include <random>
 
 using namespace winmd::reader;
 
@@ -50,3 +51,104 @@ TEST_CASE("filter_exclude_include_precedence")
 
     REQUIRE(!f.includes("N.T"));
 }
+
+TEST_CASE("filter_partial_segments")
+{
+    std::vector<std::string> include = { "Windows.Fo", "Windows.Foundation.Collections.IVector", "Windows.Win32.UI." };
+    std::vector<std::string> exclude = { "Windows.Foundation.Collections", "Windows.Win32" };
+
+    filter f{ include, exclude };
+
+    // A rule matches any name that starts with it, even part way through a segment.
+    REQUIRE(f.includes("Windows.Foundation.Uri"));
+    REQUIRE(f.includes("Windows.FooBar.T"));
+    REQUIRE(!f.includes("Windows.Data.T"));
+    REQUIRE(!f.includes("Windows.Foundation.Collections.IMap"));
+    REQUIRE(f.includes("Windows.Foundation.Collections.IVectorView"));
+    REQUIRE(!f.includes("Windows.Win32.Foundation.HRESULT"));
+    REQUIRE(f.includes("Windows.Win32.UI.Shell.T"));
+    REQUIRE(!f.includes("Windows.Win32.UIX.T"));
+
+    REQUIRE(f.decide("Windows.FooBar") == filter::namespace_decision::include);
+    REQUIRE(f.decide("Windows.Foundation.Metadata") == filter::namespace_decision::include);
+
+    // Types named Collections* in Windows.Foundation would match the longer exclude.
+    REQUIRE(f.decide("Windows.Foundation") == filter::namespace_decision::per_type);
+    REQUIRE(f.decide("Windows.Foundation.Collections") == filter::namespace_decision::per_type);
+    REQUIRE(f.decide("Windows.Win32") == filter::namespace_decision::exclude);
+    REQUIRE(f.decide("Windows.Win32.Graphics") == filter::namespace_decision::exclude);
+    REQUIRE(f.decide("Windows.Win32.UI.Shell") == filter::namespace_decision::include);
+    REQUIRE(f.decide("Other") == filter::namespace_decision::exclude);
+    REQUIRE(filter{}.decide("Other") == filter::namespace_decision::include);
+}
+
+TEST_CASE("filter_matches_linear_rules")
+{
+    // The rules as a linear list, longest first and excludes before includes, as the filter used to keep them.
+    auto reference = [](std::vector<std::pair<std::string, bool>> rules, std::string_view const& type)
+    {
+        std::sort(rules.begin(), rules.end(), [](auto const& lhs, auto const& rhs)
+        {
+            return std::pair{ lhs.first.size(), !lhs.second } > std::pair{ rhs.first.size(), !rhs.second };
+        });
+
+        for (auto&& rule : rules)
+        {
+            if (winmd::impl::starts_with(type, rule.first))
+            {
+                return rule.second;
+            }
+        }
+
+        return rules.empty();
+    };
+
+    std::mt19937 random{ 7 };
+    std::vector<std::string> const segments = { "A", "AB", "B", "Ba", "C" };
+
+    auto make_name = [&](std::size_t const count)
+    {
+        std::string name;
+
+        for (std::size_t segment = 0; segment < count; ++segment)
+        {
+            name += (segment ? "." : "") + segments[random() % segments.size()];
+        }
+
+        return name;
+    };
+
+    for (int round = 0; round < 200; ++round)
+    {
+        std::vector<std::string> include;
+        std::vector<std::string> exclude;
+        std::vector<std::pair<std::string, bool>> rules;
+
+        for (auto count = random() % 8; count; --count)
+        {
+            // A rule that starts with a dot reaches into the type names of the global namespace.
+            auto rule = (random() % 8 ? "" : ".") + make_name(1 + random() % 3);
+            rule.resize(1 + random() % rule.size());
+            auto const is_include = random() % 2 == 0;
+            (is_include ? include : exclude).push_back(rule);
+            rules.emplace_back(rule, is_include);
+        }
+
+        filter const f{ include, exclude };
+
+        for (int type = 0; type < 50; ++type)
+        {
+            // Some types are in the global namespace, which has no segments for the rules to match.
+            auto const name = random() % 4 ? make_name(2 + random() % 3) : "." + make_name(1);
+            REQUIRE(f.includes(name) == reference(rules, name));
+
+            auto const type_namespace = std::string_view{ name }.substr(0, name.rfind('.'));
+            auto const decision = f.decide(type_namespace);
+
+            if (decision != filter::namespace_decision::per_type)
+            {
+                REQUIRE((decision == filter::namespace_decision::include) == reference(rules, name));
+            }
+        }
+    }
+}
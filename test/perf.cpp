@@ -0,0 +1,276 @@
+#include <winmd_reader.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "synthetic_winmd.h"
+
+using namespace winmd::reader;
+
+// Reports open time, cache build time, find throughput and signature decode throughput for the given .winmd
+// files, e.g. "winmd_perf Windows.Win32.winmd". Without files, a synthetic pair is generated in the temporary
+// directory; the synthetic options accepted by winmd_synthesize control its size.
+
+namespace
+{
+    template <typename F>
+    double seconds(F&& callback)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        callback();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report_time(std::string_view const& name, double const elapsed, uint32_t const repeat)
+    {
+        std::cout << name << ": " << elapsed * 1000 / repeat << " ms" << std::endl;
+    }
+
+    void report_rate(std::string_view const& name, double const elapsed, std::size_t const operations)
+    {
+        std::cout << name << ": " << static_cast<uint64_t>(operations / elapsed) << " per second" << std::endl;
+    }
+
+    // Resident set size in bytes, or zero where it is not available.
+    std::size_t resident_set() noexcept
+    {
+#if defined(__linux__)
+        std::ifstream statm{ "/proc/self/statm" };
+        std::size_t size{};
+        std::size_t resident{};
+
+        if (statm >> size >> resident)
+        {
+            return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return 0;
+    }
+
+    std::vector<std::string> write_synthetic_files(winmd::test::synthetic_options options)
+    {
+        auto const directory = std::filesystem::temp_directory_path();
+        std::vector<std::string> files;
+        files.push_back(winmd::test::write_synthetic_winmd(directory / "winmd_perf_synthetic.winmd", options));
+        options.referenced_assembly = options.assembly_name;
+        options.assembly_name = "Referencing";
+        files.push_back(winmd::test::write_synthetic_winmd(directory / "winmd_perf_referencing.winmd", options));
+        return files;
+    }
+
+    void run(std::vector<std::string> const& files, uint32_t const repeat)
+    {
+        uintmax_t bytes{};
+
+        for (auto&& file : files)
+        {
+            bytes += std::filesystem::file_size(file);
+        }
+
+        std::cout << files.size() << " files, " << bytes << " bytes" << std::endl;
+
+        // Measured first, before the timing loops below leave freed memory resident in the heap.
+        auto const resident_before = resident_set();
+        cache const c{ files };
+
+        if (auto const resident = resident_set())
+        {
+            std::cout << "cache resident set: " << (resident - resident_before) / 1024 << " KiB" << std::endl;
+        }
+
+        report_time("database open", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&& file : files)
+                {
+                    database const db{ file };
+                }
+            }
+        }), repeat);
+
+        report_time("cache build", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                cache const c{ files };
+            }
+        }), repeat);
+
+        report_time("cache build (parallel_load)", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                cache const c{ files, cache::parallel_load{} };
+            }
+        }), repeat);
+
+        report_time("cache build (lazy_classification)", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                cache const c{ files, cache::lazy_classification{} };
+            }
+        }), repeat);
+
+        // The first construction writes the snapshot that the timed ones load.
+        auto const snapshot_path = (std::filesystem::temp_directory_path() / "winmd_perf.snapshot").string();
+        std::filesystem::remove(snapshot_path);
+        cache{ files, cache::snapshot{ snapshot_path } };
+
+        report_time("cache load (snapshot)", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                cache const c{ files, cache::snapshot{ snapshot_path } };
+
+                if (!c.loaded_from_snapshot())
+                {
+                    winmd::impl::throw_invalid("The cache snapshot was not loaded");
+                }
+            }
+        }), repeat);
+
+        std::vector<std::pair<std::string_view, std::string_view>> keys;
+
+        for (auto&&[ns, members] : c.namespaces())
+        {
+            for (auto&&[name, type] : members.types)
+            {
+                keys.emplace_back(ns, name);
+            }
+        }
+
+        std::shuffle(keys.begin(), keys.end(), std::mt19937{ 42 });
+        std::size_t found{};
+
+        report_rate("cache::find", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&&[ns, name] : keys)
+                {
+                    found += static_cast<bool>(c.find(ns, name));
+                }
+            }
+        }), keys.size() * repeat);
+
+        if (found != keys.size() * repeat)
+        {
+            winmd::impl::throw_invalid("cache::find missed a type it enumerated");
+        }
+
+        std::size_t methods{};
+        std::size_t attributes{};
+
+        for (auto&& db : c.databases())
+        {
+            methods += db.MethodDef.size();
+            attributes += db.CustomAttribute.size();
+        }
+
+        // Fold every decode into a checksum so that none of them can be optimized away.
+        std::size_t checksum{};
+
+        report_rate("MethodDefSig decode", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&& db : c.databases())
+                {
+                    for (auto&& method : db.MethodDef)
+                    {
+                        auto const signature = method.Signature();
+                        checksum += signature.Params().second - signature.Params().first;
+                    }
+                }
+            }
+        }), methods * repeat);
+
+        report_rate("MethodDefSigView decode", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&& db : c.databases())
+                {
+                    for (auto&& method : db.MethodDef)
+                    {
+                        for (auto&& param : method.SignatureView().Params())
+                        {
+                            checksum += static_cast<std::size_t>(param.Type().element_type());
+                        }
+                    }
+                }
+            }
+        }), methods * repeat);
+
+        report_rate("CustomAttributeSig decode", seconds([&]
+        {
+            for (uint32_t i = 0; i < repeat; ++i)
+            {
+                for (auto&& db : c.databases())
+                {
+                    for (auto&& attribute : db.CustomAttribute)
+                    {
+                        checksum += attribute.Value().FixedArgs().size();
+                    }
+                }
+            }
+        }), attributes * repeat);
+
+        std::cout << "checksum: " << checksum << std::endl;
+    }
+}
+
+int main(int const argc, char** argv)
+{
+    try
+    {
+        winmd::test::synthetic_options options;
+        options.namespaces = 64;
+        options.types_per_namespace = 128;
+        options.methods_per_namespace = 64;
+        uint32_t repeat = 5;
+        std::vector<std::string> files;
+
+        for (int arg = 1; arg < argc; ++arg)
+        {
+            std::string_view const name = argv[arg];
+
+            if (!winmd::impl::starts_with(name, "--"))
+            {
+                files.emplace_back(name);
+                continue;
+            }
+
+            if (arg + 1 == argc)
+            {
+                winmd::impl::throw_invalid("Option '", name, "' is missing a value");
+            }
+
+            std::string_view const value = argv[++arg];
+
+            if (name == "--repeat")
+            {
+                repeat = std::max(1, std::stoi(std::string{ value }));
+            }
+            else if (!winmd::test::set_synthetic_option(options, name, value))
+            {
+                winmd::impl::throw_invalid("Unknown option '", name, "'");
+            }
+        }
+
+        if (files.empty())
+        {
+            files = write_synthetic_files(options);
+        }
+
+        run(files, repeat);
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <winmd_reader.h>
+#include <iostream>
+#include "synthetic_winmd.h"
+
+// Writes a synthetic .winmd file, e.g. "winmd_synthesize big.winmd --namespaces 200 --types 150". Generate a
+// second file with "--assembly Other --reference Synthetic" to get cross-file TypeRefs into the first one.
+
+int main(int const argc, char** argv)
+{
+    if (argc < 2 || argc % 2 != 0)
+    {
+        std::cerr << "usage: " << argv[0] << " <output.winmd> [--assembly name] [--reference name] [--namespaces n] [--types n]"
+            " [--fields n] [--methods n] [--params n] [--nested-every n] [--nested-per-type n] [--arch-every n]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        winmd::test::synthetic_options options;
+
+        for (int arg = 2; arg < argc; arg += 2)
+        {
+            if (!winmd::test::set_synthetic_option(options, argv[arg], argv[arg + 1]))
+            {
+                std::cerr << "unknown option '" << argv[arg] << "'" << std::endl;
+                return 1;
+            }
+        }
+
+        auto const path = winmd::test::write_synthetic_winmd(argv[1], options);
+        std::cout << path << ": " << std::filesystem::file_size(path) << " bytes" << std::endl;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,1211 @@
+#include "pch.h"
+#include <winmd_reader.h>
+#include <random>
+#include "synthetic_winmd.h"
+
+using namespace winmd::reader;
+
+namespace
+{
+    // Writes the referenced "Synthetic" assembly and a second assembly whose types point into it through TypeRefs.
+    std::vector<std::string> write_synthetic_pair(winmd::test::synthetic_options options = {})
+    {
+        auto const directory = std::filesystem::temp_directory_path();
+        std::vector<std::string> files;
+        files.push_back(winmd::test::write_synthetic_winmd(directory / "winmd_test_synthetic.winmd", options));
+        options.referenced_assembly = options.assembly_name;
+        options.assembly_name = "Referencing";
+        files.push_back(winmd::test::write_synthetic_winmd(directory / "winmd_test_referencing.winmd", options));
+        return files;
+    }
+
+    // The bytes of the given row of a table, located in the image by their value. columns must cover the row.
+    std::vector<uint8_t>::iterator find_row(std::vector<uint8_t>& image, table_base const& table, uint32_t const row, uint32_t const columns)
+    {
+        std::vector<uint8_t> bytes;
+
+        for (uint32_t column = 0; column < columns; ++column)
+        {
+            auto const value = table.get_value<uint64_t>(row, column);
+
+            for (uint32_t byte = 0; byte < table.column_size(column); ++byte)
+            {
+                bytes.push_back(static_cast<uint8_t>(value >> (byte * 8)));
+            }
+        }
+
+        auto const found = std::search(image.begin(), image.end(), bytes.begin(), bytes.end());
+        REQUIRE(found != image.end());
+        REQUIRE(std::search(found + 1, image.end(), bytes.begin(), bytes.end()) == image.end());
+        return found;
+    }
+
+    // Overwrites one column of a row with value, little-endian.
+    void write_column(std::vector<uint8_t>& image, table_base const& table, uint32_t const row, uint32_t const columns, uint32_t const column, uint32_t const value)
+    {
+        auto position = find_row(image, table, row, columns);
+
+        for (uint32_t previous = 0; previous < column; ++previous)
+        {
+            position += table.column_size(previous);
+        }
+
+        for (uint32_t byte = 0; byte < table.column_size(column); ++byte)
+        {
+            position[byte] = static_cast<uint8_t>(value >> (byte * 8));
+        }
+    }
+}
+
+TEST_CASE("synthetic_deterministic")
+{
+    winmd::test::synthetic_options options;
+    REQUIRE(winmd::test::make_synthetic_winmd(options) == winmd::test::make_synthetic_winmd(options));
+
+    options.types_per_namespace *= 2;
+    REQUIRE(winmd::test::make_synthetic_winmd(options) != winmd::test::make_synthetic_winmd());
+}
+
+TEST_CASE("synthetic_database")
+{
+    winmd::test::synthetic_options options;
+    auto const files = write_synthetic_pair(options);
+    database db(files[0]);
+
+    REQUIRE(db.Module.size() == 1);
+    REQUIRE(db.Assembly.size() == 1);
+    REQUIRE(db.Assembly.begin().Name() == "Synthetic");
+
+    std::size_t structs{};
+    std::size_t nested{};
+
+    for (auto&& type : db.TypeDef)
+    {
+        if (type.TypeNamespace() == "Synthetic.N0" && get_category(type) == category::struct_type)
+        {
+            ++structs;
+        }
+
+        nested += type.Flags().Visibility() == TypeVisibility::NestedPublic;
+    }
+
+    // Half of the types are structs, and every eighth one is emitted once per architecture variant.
+    REQUIRE(structs == options.types_per_namespace / 2 + options.types_per_namespace / options.arch_variant_every);
+    REQUIRE(nested == db.NestedClass.size());
+    REQUIRE(nested > 0);
+
+    for (auto&& method : db.MethodDef)
+    {
+        if (method.SpecialName())
+        {
+            continue;
+        }
+
+        auto const signature = method.Signature();
+        REQUIRE(static_cast<std::size_t>(signature.Params().second - signature.Params().first) == size(method.ParamList()));
+    }
+
+    for (auto&& attribute : db.CustomAttribute)
+    {
+        REQUIRE(attribute.Value().FixedArgs().size() == 1);
+    }
+}
+
+TEST_CASE("synthetic_cache")
+{
+    auto const files = write_synthetic_pair();
+    cache c(files);
+    REQUIRE(c.databases().size() == 2);
+
+    auto const type = c.find("Synthetic.N1", "S0");
+    REQUIRE(type);
+    REQUIRE(c.find("Referencing.N1", "S0"));
+    REQUIRE(!c.find("Synthetic.N1", "Missing"));
+
+    // Same-named architecture variants are selected by their SupportedArchitectureAttribute.
+    REQUIRE(GetSupportedArchitectures(type) != Architecture::None);
+    REQUIRE(c.namespaces().at("Synthetic.N1").variants.at("S0").size() == 2);
+    auto const x86_type = c.find("Synthetic.N1", "S0", Architecture::X86);
+    auto const x64_type = c.find("Synthetic.N1", "S0", Architecture::X64);
+    REQUIRE(x86_type == type);
+    REQUIRE(x86_type.TypeName() == "S0@X86");
+    REQUIRE(x64_type != x86_type);
+    REQUIRE((GetSupportedArchitectures(x64_type) & Architecture::X64));
+    REQUIRE(c.find("Synthetic.N1", "S0", Architecture::Arm64) == x64_type);
+    REQUIRE(c.find("Synthetic.N1", "S0", Architecture::None) == type);
+    REQUIRE(c.find("Synthetic.N1", "S0@X86", Architecture::X64) == x86_type);
+    REQUIRE(c.find("Synthetic.N1", "S1", Architecture::X86) == c.find("Synthetic.N1", "S1"));
+    REQUIRE(!c.find("Synthetic.N1", "Missing", Architecture::X86));
+
+    auto const& referencing = c.databases().back();
+    std::size_t resolved{};
+
+    for (auto&& ref : referencing.TypeRef)
+    {
+        if (ref.ResolutionScope().type() != ResolutionScope::TypeRef)
+        {
+            continue;
+        }
+
+        auto const x86 = find(ref, Architecture::X86);
+        auto const x64 = find(ref, Architecture::X64);
+        REQUIRE(x86);
+        REQUIRE(x64);
+        REQUIRE(x86.TypeName() == ref.TypeName());
+
+        auto const enclosing = find(ref.ResolutionScope().TypeRef(), Architecture::X86);
+
+        if (GetSupportedArchitectures(enclosing) != Architecture::None)
+        {
+            REQUIRE(x86 != x64);
+            REQUIRE(x86.FieldList().first.Signature().Type().element_type() == ElementType::U4);
+            REQUIRE(x64.FieldList().first.Signature().Type().element_type() == ElementType::U8);
+        }
+
+        ++resolved;
+    }
+
+    REQUIRE(resolved > 0);
+
+    for (auto&& db : c.databases())
+    {
+        for (auto&& row : db.NestedClass)
+        {
+            auto const enclosing = row.EnclosingType();
+            auto const nested = row.NestedType();
+            REQUIRE(c.find_nested(enclosing, nested.TypeName()) == nested);
+            REQUIRE(c.find_nested(enclosing, nested.TypeDisplayName()) == nested);
+            REQUIRE(!c.find_nested(enclosing, "Missing"));
+            REQUIRE(!c.find_nested(nested, nested.TypeName()));
+        }
+    }
+
+    auto const native_type_name = referencing.find_attribute_type("Windows.Win32.Foundation.Metadata", "NativeTypeNameAttribute");
+    REQUIRE(native_type_name);
+    auto const supported_architecture = referencing.find_attribute_type("Windows.Win32.Foundation.Metadata", "SupportedArchitectureAttribute");
+    REQUIRE(supported_architecture);
+    REQUIRE(supported_architecture != native_type_name);
+    REQUIRE(!referencing.find_attribute_type("Windows.Win32.Foundation.Metadata", "NativeTypeName"));
+    REQUIRE(!referencing.find_attribute_type("Windows.Win32.Foundation", "NativeTypeNameAttribute"));
+
+    for (auto&& param : referencing.Param)
+    {
+        REQUIRE(has_attribute(param, native_type_name) == (param.Sequence() == 1));
+    }
+}
+
+TEST_CASE("synthetic_resolve_type_refs")
+{
+    auto const files = write_synthetic_pair();
+    cache c(files.back());
+    auto const& referencing = c.databases().front();
+    REQUIRE(!referencing.resolved_type_ref(referencing.TypeRef.begin(), Architecture::X86));
+
+    // Only the referencing assembly is loaded, so its references into the other one cannot resolve yet.
+    auto const missing = c.resolve_type_refs(Architecture::X86);
+    REQUIRE(missing == referencing.TypeRef.size());
+    REQUIRE(referencing.unresolved_type_refs(Architecture::X86) == missing);
+    REQUIRE(referencing.resolved_type_ref(referencing.TypeRef.begin(), Architecture::X86));
+    REQUIRE(!referencing.resolved_type_ref(referencing.TypeRef.begin(), Architecture::X64));
+
+    c.add_database(files.front());
+    auto const& synthetic = c.databases().back();
+    REQUIRE(synthetic.resolved_type_ref(synthetic.TypeRef.begin(), Architecture::X86));
+    REQUIRE(referencing.unresolved_type_refs(Architecture::X86) < missing);
+
+    cache const fresh(files);
+    std::size_t unresolved{};
+
+    for (auto&& type : referencing.TypeRef)
+    {
+        auto const expected = find(fresh.databases().back().TypeRef[type.index()], Architecture::X86);
+        auto const resolved = *referencing.resolved_type_ref(type, Architecture::X86);
+        REQUIRE(static_cast<bool>(resolved) == static_cast<bool>(expected));
+        REQUIRE(find(type, Architecture::X86) == resolved);
+        unresolved += !resolved;
+
+        if (resolved)
+        {
+            REQUIRE(resolved.TypeNamespace() == expected.TypeNamespace());
+            REQUIRE(resolved.TypeName() == expected.TypeName());
+            REQUIRE(resolved.FieldList().first.Signature().Type().element_type() == expected.FieldList().first.Signature().Type().element_type());
+        }
+    }
+
+    // The references to System types remain unresolved.
+    REQUIRE(unresolved == referencing.unresolved_type_refs(Architecture::X86));
+    REQUIRE(unresolved > 0);
+}
+
+TEST_CASE("synthetic_type_handle")
+{
+    auto const files = write_synthetic_pair();
+    type_handle stale;
+
+    {
+        cache c(files);
+        auto const type = c.find("Synthetic.N1", "S1");
+        type_handle const handle = type;
+        REQUIRE(handle);
+        REQUIRE(handle.get() == type);
+        REQUIRE(handle->TypeName() == "S1");
+        REQUIRE(handle == type_handle{ c.find("Synthetic.N1", "S1") });
+        REQUIRE(handle != type_handle{ c.find("Synthetic.N1", "S4") });
+        REQUIRE(!type_handle{});
+        REQUIRE(!type_handle{}.get());
+
+        // The cache itself only holds handles.
+        for (auto&&[name, member] : c.namespaces().at("Synthetic.N1").types)
+        {
+            REQUIRE(member->TypeName() == name);
+        }
+
+        stale = handle;
+    }
+
+    // Registry slots are reused with a new generation, so a handle into a closed database resolves to a null row.
+    cache c(files);
+    REQUIRE(stale);
+    REQUIRE(!stale.get());
+    REQUIRE(type_handle{ c.find("Synthetic.N1", "S1") } != stale);
+
+    // Far more databases than there are slots may be opened over time, as long as few are open at once.
+    winmd::impl::database_registry registry;
+    auto const db = &c.databases().front();
+    auto const first = registry.add(db);
+    registry.remove(first);
+
+    for (uint32_t i = 0; i < 200000; ++i)
+    {
+        auto const id = registry.add(db);
+        REQUIRE(registry.get(id) == db);
+        REQUIRE(!registry.get(first));
+        registry.remove(id);
+        REQUIRE(!registry.get(id));
+    }
+
+    // Each slot retires before its generation wraps, so no id is issued twice.
+    REQUIRE(registry.add(db) != first);
+
+    winmd::impl::database_registry full;
+    std::vector<uint32_t> open;
+
+    for (uint32_t i = 0; i < winmd::impl::database_registry::slot_mask; ++i)
+    {
+        open.push_back(full.add(db));
+    }
+
+    REQUIRE_THROWS_AS(full.add(db), std::invalid_argument);
+    full.remove(open.back());
+    REQUIRE(full.get(full.add(db)) == db);
+    REQUIRE(!full.get(open.back()));
+}
+
+TEST_CASE("synthetic_snapshot")
+{
+    auto const files = write_synthetic_pair();
+    auto const path = (std::filesystem::temp_directory_path() / "winmd_test_synthetic.snapshot").string();
+    std::filesystem::remove(path);
+
+    auto same = [](TypeDef const& left, TypeDef const& right)
+    {
+        return static_cast<bool>(left) == static_cast<bool>(right) &&
+            (!left || (left.index() == right.index() && left.get_database().path() == right.get_database().path()));
+    };
+
+    cache const built(files, cache::snapshot{ path });
+    REQUIRE(!built.loaded_from_snapshot());
+    REQUIRE(std::filesystem::exists(path));
+
+    cache const loaded(files, cache::snapshot{ path });
+    REQUIRE(loaded.loaded_from_snapshot());
+
+    // Lookups are answered from the mapped file before any container is built.
+    for (auto&&[ns, members] : built.namespaces())
+    {
+        for (auto&&[name, type] : members.types)
+        {
+            REQUIRE(same(loaded.find(ns, name), type));
+        }
+
+        for (auto&&[name, variants] : members.variants)
+        {
+            REQUIRE(same(loaded.find(ns, name), built.find(ns, name)));
+            REQUIRE(same(loaded.find(ns, name, Architecture::X86), built.find(ns, name, Architecture::X86)));
+            REQUIRE(same(loaded.find(ns, name, Architecture::Arm64), built.find(ns, name, Architecture::Arm64)));
+        }
+    }
+
+    REQUIRE(!loaded.find("Synthetic.N1", "Missing"));
+
+    for (auto&& db : loaded.databases())
+    {
+        for (auto&& row : db.NestedClass)
+        {
+            auto const nested = row.NestedType();
+            REQUIRE(loaded.find_nested(row.EnclosingType(), nested.TypeName()) == nested);
+            REQUIRE(loaded.find_nested(row.EnclosingType(), nested.TypeDisplayName()) == nested);
+            REQUIRE(!loaded.find_nested(row.EnclosingType(), "Missing"));
+        }
+    }
+
+    auto same_types = [&](std::vector<type_handle> const& left, std::vector<type_handle> const& right)
+    {
+        return std::equal(left.begin(), left.end(), right.begin(), right.end(), [&](TypeDef const& left, TypeDef const& right)
+        {
+            return same(left, right);
+        });
+    };
+
+    REQUIRE(loaded.namespaces().size() == built.namespaces().size());
+
+    for (auto&&[ns, members] : built.namespaces())
+    {
+        auto const& other = loaded.namespaces().at(ns);
+        REQUIRE(other.types.size() == members.types.size());
+        REQUIRE(other.variants.size() == members.variants.size());
+        REQUIRE(same_types(other.interfaces, members.interfaces));
+        REQUIRE(same_types(other.classes, members.classes));
+        REQUIRE(same_types(other.enums, members.enums));
+        REQUIRE(same_types(other.structs, members.structs));
+        REQUIRE(same_types(other.delegates, members.delegates));
+        REQUIRE(same_types(other.attributes, members.attributes));
+        REQUIRE(same_types(other.contracts, members.contracts));
+
+        for (auto&& type : members.structs)
+        {
+            REQUIRE(same_types(loaded.nested_types(loaded.find(ns, type->TypeName())), built.nested_types(type)));
+        }
+    }
+
+    // A snapshot of other files, or of a changed file, is rebuilt and replaced.
+    cache const referencing(std::vector<std::string>{ files.back() }, cache::snapshot{ path });
+    REQUIRE(!referencing.loaded_from_snapshot());
+    REQUIRE(cache(std::vector<std::string>{ files.back() }, cache::snapshot{ path }).loaded_from_snapshot());
+
+    winmd::test::synthetic_options options;
+    options.types_per_namespace *= 2;
+    auto const changed = write_synthetic_pair(options);
+    REQUIRE(!cache(std::vector<std::string>{ changed.back() }, cache::snapshot{ path }).loaded_from_snapshot());
+
+    {
+        std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+        stream << "not a snapshot";
+    }
+
+    REQUIRE(!cache(changed, cache::snapshot{ path }).loaded_from_snapshot());
+
+    // Adding a database moves the cache off the mapped index.
+    cache extended(changed, cache::snapshot{ path });
+    REQUIRE(extended.loaded_from_snapshot());
+    REQUIRE(extended.find("Referencing.N1", "S0"));
+    extended.add_database(changed.front());
+    REQUIRE(extended.find("Referencing.N1", "S0"));
+    REQUIRE(extended.find("Synthetic.N1", "S0", Architecture::X64));
+    REQUIRE(extended.namespaces().at("Synthetic.N1").types.size() == extended.namespaces().at("Referencing.N1").types.size());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("synthetic_lazy_classification")
+{
+    auto const files = write_synthetic_pair();
+    cache const eager(files);
+    cache lazy(files, cache::lazy_classification{});
+
+    REQUIRE(lazy.find("Synthetic.N1", "S1") == lazy.namespaces().at("Synthetic.N1").types.at("S1"));
+    REQUIRE(lazy.find("Synthetic.N1", "S0", Architecture::X64));
+
+    for (auto&&[ns, members] : lazy.namespaces())
+    {
+        REQUIRE(!members.classified());
+        REQUIRE(members.types.size() == eager.namespaces().at(ns).types.size());
+    }
+
+    // Every thread races to classify every namespace; each must see the complete lists.
+    std::vector<std::size_t> counts(4);
+    std::vector<std::thread> threads;
+
+    for (std::size_t thread = 0; thread < counts.size(); ++thread)
+    {
+        threads.emplace_back([&, thread]
+        {
+            for (auto&&[ns, members] : lazy.namespaces())
+            {
+                counts[thread] += members.structs.size() + members.enums.size() + members.interfaces.size() + members.delegates.size() + members.classes.size();
+            }
+        });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::size_t expected{};
+
+    for (auto&&[ns, members] : eager.namespaces())
+    {
+        REQUIRE(members.classified());
+        auto const& other = lazy.namespaces().at(ns);
+        REQUIRE(other.classified());
+        REQUIRE(std::equal(members.structs.begin(), members.structs.end(), other.structs.begin(), other.structs.end(), [](TypeDef const& left, TypeDef const& right)
+        {
+            return left.TypeName() == right.TypeName() && left.index() == right.index();
+        }));
+
+        expected += members.structs.size() + members.enums.size() + members.interfaces.size() + members.delegates.size() + members.classes.size();
+    }
+
+    REQUIRE(expected > 0);
+    REQUIRE(std::count(counts.begin(), counts.end(), expected) == static_cast<std::ptrdiff_t>(counts.size()));
+
+    // Types added to a classified namespace are classified as they are added.
+    lazy.remove_type("Synthetic.N1", "S1");
+    auto const structs = lazy.namespaces().at("Synthetic.N1").structs.size();
+    REQUIRE(structs + 1 == eager.namespaces().at("Synthetic.N1").structs.size());
+    winmd::test::synthetic_options options;
+    options.namespaces = 8;
+    options.types_per_namespace *= 2;
+    auto const more = (std::filesystem::temp_directory_path() / "winmd_test_lazy.winmd").string();
+    winmd::test::write_synthetic_winmd(more, options);
+    lazy.add_database(more);
+    REQUIRE(lazy.namespaces().at("Synthetic.N1").structs.size() > structs);
+    REQUIRE(lazy.find("Synthetic.N7", "S1"));
+    REQUIRE(!lazy.namespaces().at("Synthetic.N7").classified());
+    REQUIRE(!lazy.namespaces().at("Synthetic.N7").structs.empty());
+}
+
+TEST_CASE("synthetic_filter_pushdown")
+{
+    auto const files = write_synthetic_pair();
+    filter const f{ std::vector<std::string>{ "Synthetic.N1", "Referencing", "Synthetic.N2.S1" }, std::vector<std::string>{ "Referencing.N2", "Synthetic.N1.E" } };
+    cache const c(files, f, cache::lazy_classification{});
+
+    // Excluded namespaces never enter the cache, so they are never classified.
+    std::vector<std::string_view> namespaces;
+
+    for (auto&&[ns, members] : c.namespaces())
+    {
+        namespaces.push_back(ns);
+        REQUIRE(f.includes(members));
+    }
+
+    REQUIRE(namespaces == std::vector<std::string_view>{ "Referencing.N0", "Referencing.N1", "Referencing.N3", "Synthetic.N1", "Synthetic.N2" });
+    REQUIRE(c.namespaces().at("Synthetic.N1").enums.empty());
+    REQUIRE(!c.namespaces().at("Synthetic.N1").structs.empty());
+    REQUIRE(c.find("Synthetic.N2", "S1"));
+    REQUIRE(c.find("Synthetic.N2", "S13"));
+    REQUIRE(!c.find("Synthetic.N2", "S2"));
+
+    cache const unfiltered(files);
+
+    for (auto&&[ns, members] : unfiltered.namespaces())
+    {
+        for (auto&&[name, type] : members.types)
+        {
+            REQUIRE(static_cast<bool>(c.find(ns, name)) == f.includes(type));
+        }
+    }
+}
+
+TEST_CASE("synthetic_for_each_namespace_parallel")
+{
+    winmd::test::synthetic_options options;
+    options.namespaces = 12;
+    auto const files = write_synthetic_pair(options);
+    cache const c(files, cache::lazy_classification{});
+    filter const f{ std::vector<std::string>{ "Synthetic", "Referencing.N1" }, std::vector<std::string>{ "Synthetic.N3" } };
+
+    std::mutex lock;
+    std::map<std::string_view, std::size_t> visits;
+    std::set<std::thread::id> threads;
+
+    for_each_namespace_parallel(c, f, [&](std::string_view const& ns, cache::namespace_members const& members)
+    {
+        // Names, lookups and lazy classification from several threads at once.
+        std::size_t checked{};
+
+        for (auto&& type : members.structs)
+        {
+            checked += c.find(ns, type->TypeName()) == type;
+        }
+
+        for (auto&&[name, type] : members.types)
+        {
+            checked += type->TypeName() == name;
+        }
+
+        std::lock_guard const guard{ lock };
+        REQUIRE(checked == members.structs.size() + members.types.size());
+        ++visits[ns];
+        threads.insert(std::this_thread::get_id());
+    }, 4);
+
+    std::size_t expected{};
+
+    for (auto&&[ns, members] : c.namespaces())
+    {
+        if (f.includes(members))
+        {
+            ++expected;
+            REQUIRE(visits[ns] == 1);
+            REQUIRE(members.classified());
+        }
+        else
+        {
+            REQUIRE(!visits.count(ns));
+        }
+    }
+
+    REQUIRE(visits.size() == expected);
+    REQUIRE(expected > 0);
+    REQUIRE(expected < c.namespaces().size());
+
+    REQUIRE_THROWS_AS(for_each_namespace_parallel(c, filter{}, [](std::string_view const& ns, cache::namespace_members const&)
+    {
+        if (ns == "Synthetic.N5")
+        {
+            winmd::impl::throw_invalid("callback failed");
+        }
+    }, 4), std::invalid_argument);
+}
+
+TEST_CASE("parallel_for_weighted")
+{
+    // A few heavy items among many light ones; every index must be called exactly once.
+    std::vector<std::size_t> weights(100, 1);
+    weights[3] = 1000;
+    weights[50] = 500;
+    std::vector<std::atomic<uint32_t>> calls(weights.size());
+
+    winmd::impl::parallel_for_weighted(weights, 4, [&](std::size_t const index)
+    {
+        ++calls[index];
+    });
+
+    REQUIRE(std::all_of(calls.begin(), calls.end(), [](auto const& count) { return count == 1; }));
+
+    std::vector<std::size_t> serial;
+    winmd::impl::parallel_for_weighted(weights, 1, [&](std::size_t const index) { serial.push_back(index); });
+    REQUIRE(serial.size() == weights.size());
+    REQUIRE(serial[0] == 3);
+    REQUIRE(serial[1] == 50);
+}
+
+TEST_CASE("synthetic_concurrent_readers")
+{
+    // Run under ThreadSanitizer (-DWINMD_SANITIZE_THREAD=ON) to check that shared readers need no locking.
+    auto const files = write_synthetic_pair();
+    auto const path = (std::filesystem::temp_directory_path() / "winmd_test_concurrent.snapshot").string();
+    std::filesystem::remove(path);
+    cache{ files, cache::snapshot{ path } };
+
+    cache lazy(files, cache::lazy_classification{});
+    lazy.enable_memo(16 * 1024);
+    cache const mapped(files, cache::snapshot{ path });
+    REQUIRE(mapped.loaded_from_snapshot());
+
+    // Catch assertions are not thread-safe, so each thread tallies what it read and any mismatches.
+    struct tally
+    {
+        std::size_t types{};
+        std::size_t errors{};
+    };
+
+    auto read = [](cache const& c)
+    {
+        tally result;
+
+        for (auto&&[ns, members] : c.namespaces())
+        {
+            result.types += members.structs.size() + members.enums.size() + members.interfaces.size();
+
+            for (auto&&[name, handle] : members.types)
+            {
+                TypeDef const type = handle;
+                result.errors += c.find(ns, name) != type || type.TypeName() != name || type.TypeNamespace() != ns;
+
+                for (auto&& nested : c.nested_types(type))
+                {
+                    result.errors += c.find_nested(type, nested->TypeName()) != nested;
+                }
+
+                for (auto&& method : type.MethodList())
+                {
+                    auto const memoized = memoized_signature(method);
+                    auto const decoded = method.Signature();
+                    result.errors += memoized->Params().second - memoized->Params().first != decoded.Params().second - decoded.Params().first;
+                }
+
+                for (auto&& attribute : type.CustomAttribute())
+                {
+                    result.errors += memoized_value(attribute)->FixedArgs().size() != 1;
+                }
+            }
+        }
+
+        return result;
+    };
+
+    std::vector<tally> counts(8);
+    std::vector<std::thread> threads;
+
+    for (std::size_t thread = 0; thread < counts.size(); ++thread)
+    {
+        threads.emplace_back([&, thread]
+        {
+            counts[thread] = read(thread % 2 ? lazy : mapped);
+        });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto&& count : counts)
+    {
+        REQUIRE(count.errors == 0);
+        REQUIRE(count.types == counts[0].types);
+    }
+
+    REQUIRE(counts[0].types > 0);
+    REQUIRE(lazy.databases().front().memo()->get_statistics().hits > 0);
+}
+
+namespace
+{
+    // Writes next to the target and renames it into place, as tools that regenerate metadata do, so that a
+    // database still mapping the old file keeps reading the old contents.
+    void rewrite_synthetic_winmd(std::string const& path, winmd::test::synthetic_options const& options)
+    {
+        auto const temp = path + ".tmp";
+        winmd::test::write_synthetic_winmd(temp, options);
+        std::filesystem::rename(temp, path);
+    }
+
+    // Checks that an incrementally updated cache has the same contents as one built from scratch.
+    void require_same_cache(cache const& updated, cache const& built)
+    {
+        auto same = [](TypeDef const& left, TypeDef const& right)
+        {
+            return static_cast<bool>(left) == static_cast<bool>(right) &&
+                (!left || (left.index() == right.index() && left.get_database().path() == right.get_database().path()));
+        };
+
+        REQUIRE(updated.databases().size() == built.databases().size());
+        REQUIRE(updated.namespaces().size() == built.namespaces().size());
+
+        for (auto&&[ns, members] : built.namespaces())
+        {
+            auto const& other = updated.namespaces().at(ns);
+            REQUIRE(other.types.size() == members.types.size());
+            REQUIRE(other.variants.size() == members.variants.size());
+            REQUIRE(other.structs.size() == members.structs.size());
+            REQUIRE(other.enums.size() == members.enums.size());
+            REQUIRE(other.interfaces.size() == members.interfaces.size());
+
+            for (auto&&[name, type] : members.types)
+            {
+                REQUIRE(same(updated.find(ns, name), type));
+
+                for (auto&& nested : built.nested_types(type))
+                {
+                    auto const found = updated.find_nested(updated.find(ns, name), nested->TypeName());
+                    REQUIRE(same(found, nested));
+                }
+            }
+
+            for (auto&&[name, variants] : members.variants)
+            {
+                REQUIRE(same(updated.find(ns, name), built.find(ns, name)));
+                REQUIRE(same(updated.find(ns, name, Architecture::Arm64), built.find(ns, name, Architecture::Arm64)));
+            }
+        }
+    }
+}
+
+TEST_CASE("synthetic_memo_budget")
+{
+    auto const files = write_synthetic_pair();
+
+    auto memoize_all = [&](std::size_t const budget)
+    {
+        auto db = std::make_unique<database>(files[0]);
+        db->enable_memo(budget);
+
+        for (auto&& method : db->MethodDef)
+        {
+            auto const first = memoized_signature(method);
+            auto const second = memoized_signature(method);
+            REQUIRE(second->Params().second - second->Params().first == first->Params().second - first->Params().first);
+        }
+
+        return db->memo()->get_statistics();
+    };
+
+    // The budget is shared by all shards, so a memo exactly the size of everything decoded never evicts, however
+    // unevenly the entries are spread over the shards.
+    auto const total = memoize_all(std::size_t{ 1 } << 30).bytes;
+    auto const exact = memoize_all(total);
+    REQUIRE(exact.evictions == 0);
+    REQUIRE(exact.bytes == total);
+
+    auto const half = memoize_all(total / 2);
+    REQUIRE(half.evictions > 0);
+    REQUIRE(half.bytes <= total / 2);
+
+    // A budget smaller than any one entry keeps nothing rather than overshooting.
+    auto const tiny = memoize_all(16);
+    REQUIRE(tiny.entries == 0);
+    REQUIRE(tiny.bytes == 0);
+    REQUIRE(tiny.hits == 0);
+}
+
+TEST_CASE("synthetic_remove_database")
+{
+    auto const files = write_synthetic_pair();
+    auto const copy = (std::filesystem::temp_directory_path() / "winmd_test_synthetic_copy.winmd").string();
+    std::filesystem::copy_file(files[0], copy, std::filesystem::copy_options::overwrite_existing);
+
+    cache c(std::vector<std::string>{ files[0], copy, files[1] });
+    c.resolve_type_refs();
+
+    auto const& first = c.databases().front();
+    type_handle const removed = c.find("Synthetic.N0", "S1");
+    REQUIRE(removed->get_database().path() == files[0]);
+
+    // The copy's types were hidden by the first database and take its place.
+    c.remove_database(first);
+    REQUIRE(!removed.get());
+    REQUIRE(c.find("Synthetic.N0", "S1").get_database().path() == copy);
+    require_same_cache(c, cache(std::vector<std::string>{ copy, files[1] }));
+
+    for (auto&& type : c.databases().back().TypeRef)
+    {
+        if (type.TypeNamespace().rfind("Synthetic", 0) == 0)
+        {
+            auto const found = find(type, Architecture::All);
+            REQUIRE(found);
+            REQUIRE(found.get_database().path() == copy);
+        }
+    }
+
+    // Removing the last database to define a namespace removes the namespace.
+    c.remove_database(c.databases().back());
+    REQUIRE(c.namespaces().count("Referencing.N0") == 0);
+    REQUIRE(!c.find("Referencing.N0", "S0"));
+    require_same_cache(c, cache(copy));
+
+    REQUIRE_THROWS_AS(c.remove_database(database{ copy }), std::invalid_argument);
+
+    // remove_type drops the type from every index, not just the category lists.
+    auto const enclosing = c.find("Synthetic.N1", "S0@X86");
+    REQUIRE(!c.nested_types(enclosing).empty());
+    auto const structs = c.namespaces().at("Synthetic.N1").structs.size();
+    c.remove_type("Synthetic.N1", "S0@X86");
+    REQUIRE(!c.find("Synthetic.N1", "S0@X86"));
+    REQUIRE(c.find("Synthetic.N1", "S0", Architecture::X86) != enclosing);
+    REQUIRE(c.nested_types(enclosing).empty());
+    REQUIRE(c.namespaces().at("Synthetic.N1").structs.size() == structs - 1);
+}
+
+TEST_CASE("synthetic_replace_database")
+{
+    auto const directory = std::filesystem::temp_directory_path();
+    winmd::test::synthetic_options options;
+    auto const first = winmd::test::write_synthetic_winmd(directory / "winmd_test_replace_first.winmd", options);
+    options.assembly_name = "Other";
+    auto const other = winmd::test::write_synthetic_winmd(directory / "winmd_test_replace_other.winmd", options);
+
+    // The replacement keeps its place in load order, ahead of the second copy of the Synthetic namespaces.
+    options.assembly_name = "Synthetic";
+    options.namespaces = 6;
+    options.types_per_namespace = 8;
+    auto const updated = winmd::test::write_synthetic_winmd(directory / "winmd_test_replace_updated.winmd", options);
+    auto const second = (directory / "winmd_test_replace_second.winmd").string();
+    std::filesystem::copy_file(first, second, std::filesystem::copy_options::overwrite_existing);
+
+    cache c(std::vector<std::string>{ first, other, second }, cache::lazy_classification{});
+    c.namespaces().at("Synthetic.N0").structs.size();
+    auto const& replaced = c.replace_database(c.databases().front(), updated);
+    REQUIRE(&replaced == &c.databases().front());
+    REQUIRE(c.find("Synthetic.N5", "S0").get_database().path() == updated);
+    REQUIRE(c.find("Synthetic.N0", "S0@X86").get_database().path() == updated);
+    REQUIRE(c.find("Synthetic.N0", "S12").get_database().path() == second);
+    require_same_cache(c, cache(std::vector<std::string>{ updated, other, second }));
+}
+
+TEST_CASE("synthetic_reload_changed_databases")
+{
+    auto const directory = std::filesystem::temp_directory_path();
+    auto const path = (directory / "winmd_test_reload.winmd").string();
+    auto const other = (directory / "winmd_test_reload_other.winmd").string();
+    winmd::test::synthetic_options options;
+    rewrite_synthetic_winmd(path, options);
+    options.assembly_name = "Other";
+    rewrite_synthetic_winmd(other, options);
+
+    cache c(std::vector<std::string>{ path, other });
+    REQUIRE(c.reload_changed_databases() == 0);
+
+    // A reported change is reloaded even if the modification time looks the same.
+    c.notify_file_changed(path);
+    REQUIRE(c.reload_changed_databases() == 1);
+    REQUIRE(c.reload_changed_databases() == 0);
+
+    options.assembly_name = "Synthetic";
+    options.namespaces = 2;
+    rewrite_synthetic_winmd(path, options);
+    std::filesystem::last_write_time(path, c.databases().front().write_time() + std::chrono::seconds{ 2 });
+    REQUIRE(c.reload_changed_databases() == 1);
+    REQUIRE(c.namespaces().count("Synthetic.N1") == 1);
+    REQUIRE(c.namespaces().count("Synthetic.N2") == 0);
+    REQUIRE(c.databases().front().path() == path);
+
+    std::filesystem::remove(other);
+    REQUIRE(c.reload_changed_databases() == 1);
+    REQUIRE(c.databases().size() == 1);
+    REQUIRE(c.namespaces().count("Other.N0") == 0);
+}
+
+TEST_CASE("synthetic_open_modes")
+{
+    auto const files = write_synthetic_pair();
+    database const checked{ files[1] };
+    database const validated{ files[1], open_mode::validated };
+    database const trusted{ files[1], open_mode::trusted };
+
+    REQUIRE(!checked.unchecked());
+    REQUIRE(validated.unchecked());
+    REQUIRE(trusted.unchecked());
+
+    auto scan = [](database const& db)
+    {
+        std::string result;
+
+        for (auto&& type : db.TypeDef)
+        {
+            result.append(type.TypeNamespace()).append(type.TypeName());
+
+            for (auto&& method : type.MethodList())
+            {
+                auto const signature = method.Signature();
+                result.append(method.Name()).append(std::to_string(signature.Params().second - signature.Params().first));
+
+                for (auto&& param : method.ParamList())
+                {
+                    result.append(param.Name());
+                }
+            }
+        }
+
+        for (auto&& type : db.TypeRef)
+        {
+            result.append(type.TypeNamespace()).append(type.TypeName());
+        }
+
+        for (auto&& attribute : db.CustomAttribute)
+        {
+            result.append(std::to_string(attribute.Type().value())).append(std::to_string(attribute.Parent().value()));
+        }
+
+        return result;
+    };
+
+    REQUIRE(scan(checked) == scan(validated));
+    REQUIRE(scan(checked) == scan(trusted));
+
+    // The row check rejects the row one past the end.
+    REQUIRE_THROWS_AS(checked.TypeDef.get_value<uint32_t>(checked.TypeDef.size(), 0), std::invalid_argument);
+
+    cache const parallel(files, cache::parallel_load{ 2, open_mode::validated });
+    REQUIRE(parallel.databases().front().unchecked());
+    REQUIRE(parallel.find("Synthetic.N1", "S1"));
+
+    // Point the signature of the last field past the end of #Blob. A checked database only notices when the
+    // signature is read; validation rejects the file when it is opened.
+    auto image = winmd::test::make_synthetic_winmd();
+    database const original{ std::vector<uint8_t>{ image } };
+    auto const& fields = original.Field;
+    auto const last = fields.size() - 1;
+    auto const signature = find_row(image, fields, last, 3) + fields.column_size(0) + fields.column_size(1);
+    std::fill(signature, signature + fields.column_size(2), uint8_t{ 0xff });
+
+    database const corrupt{ std::vector<uint8_t>{ image } };
+    REQUIRE_THROWS_AS(corrupt.Field[last].Signature(), std::invalid_argument);
+    REQUIRE_THROWS_AS(database(std::vector<uint8_t>{ image }, nullptr, open_mode::validated), std::invalid_argument);
+}
+
+TEST_CASE("synthetic_corrupt_indices")
+{
+    // Opening a database builds per-row tables from the CustomAttribute and TypeDef tables in every mode, so
+    // indices out of range must be rejected at open rather than read past those tables.
+    auto const image = winmd::test::make_synthetic_winmd();
+    database const original{ std::vector<uint8_t>{ image } };
+    auto const method_count = original.MethodDef.size();
+
+    auto open_corrupt = [&](table_base const& table, uint32_t const row, uint32_t const columns, uint32_t const column, uint32_t const value)
+    {
+        auto corrupt = image;
+        write_column(corrupt, table, row, columns, column, value);
+        database{ std::move(corrupt) };
+    };
+
+    // A MethodDef constructor and a MemberRef constructor past the end of their tables.
+    REQUIRE_THROWS_AS(open_corrupt(original.CustomAttribute, 0, 3, 1, ((method_count + 100) << 3) | 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(open_corrupt(original.CustomAttribute, 0, 3, 1, ((original.MemberRef.size() + 100) << 3) | 3), std::invalid_argument);
+
+    // A method list that starts past the end of the MethodDef table, and one that is zero.
+    auto const type = original.find_type("Windows.Win32.Foundation.Metadata", "SupportedArchitectureAttribute").index();
+    REQUIRE_THROWS_AS(open_corrupt(original.TypeDef, type, 6, 5, method_count + 100), std::invalid_argument);
+    REQUIRE_THROWS_AS(open_corrupt(original.TypeDef, type, 6, 5, 0), std::invalid_argument);
+
+    // Mapping attribute constructors to their classes walks the method list of every type, not just attributes.
+    auto const other = original.find_type("Synthetic.N0", "S0@X86").index();
+    REQUIRE_THROWS_AS(open_corrupt(original.TypeDef, other, 6, 5, method_count + 100), std::invalid_argument);
+}
+
+TEST_CASE("synthetic_string_table")
+{
+    auto const files = write_synthetic_pair();
+    database const plain{ files[1] };
+    database indexed{ files[1] };
+    REQUIRE(!indexed.string_table_enabled());
+    indexed.enable_string_table();
+    REQUIRE(indexed.string_table_enabled());
+
+    for (auto&& type : plain.TypeDef)
+    {
+        auto const other = indexed.TypeDef[type.index()];
+        REQUIRE(type.TypeNamespace() == other.TypeNamespace());
+        REQUIRE(type.TypeName() == other.TypeName());
+        REQUIRE(type.TypeDisplayName() == other.TypeDisplayName());
+        REQUIRE(extends_type(type, "System", "ValueType") == extends_type(other, "System", "ValueType"));
+        REQUIRE(other.has_name(other.TypeNamespace(), other.TypeName()));
+        REQUIRE(!other.has_name(other.TypeNamespace(), "S0@X87"));
+    }
+
+    for (auto&& param : plain.Param)
+    {
+        REQUIRE(param.Name() == indexed.Param[param.index()].Name());
+    }
+
+    // Offsets into the middle of a string are not in the table and fall back to the terminator scan.
+    auto const name = indexed.TypeDef[1].get_value<uint32_t>(1);
+    REQUIRE(indexed.get_string(name + 1) == plain.get_string(name).substr(1));
+    REQUIRE(indexed.string_equals(name + 1, plain.get_string(name).substr(1)));
+    REQUIRE(!indexed.string_equals(name, plain.get_string(name).substr(1)));
+
+    cache c(files[0]);
+    c.enable_string_tables();
+    c.add_database(files[1]);
+
+    for (auto&& db : c.databases())
+    {
+        REQUIRE(db.string_table_enabled());
+    }
+
+    auto const type = c.find("Synthetic.N0", "S0@X86");
+    REQUIRE(type);
+    REQUIRE(type.has_name("Synthetic.N0", "S0@X86"));
+    REQUIRE(!type.has_name("Synthetic.N0", "S0"));
+    REQUIRE(extends_type(type, "System", "ValueType"));
+    REQUIRE(!extends_type(type, "System", "Enum"));
+}
+
+TEST_CASE("synthetic_attribute_values")
+{
+    auto const files = write_synthetic_pair();
+    std::vector<int32_t> expected;
+
+    auto check_values = [&](database const& db)
+    {
+        std::vector<int32_t> values;
+
+        for (auto&& attribute : db.CustomAttribute)
+        {
+            auto const signature = attribute.Value();
+            auto const& arg = std::get<ElemSig>(signature.FixedArgs()[0].value).value;
+
+            if (auto const value = std::get_if<ElemSig::EnumValue>(&arg))
+            {
+                REQUIRE(value->type.m_typedef.TypeName() == "Architecture");
+                REQUIRE(value->type.m_underlying_type == ElementType::I4);
+                REQUIRE(value->type.m_underlying_type == value->type.m_typedef.get_enum_definition().m_underlying_type);
+                values.push_back(std::get<int32_t>(value->value));
+            }
+        }
+
+        REQUIRE(!values.empty());
+        return values;
+    };
+
+    // The Architecture enum is a TypeDef in the referenced assembly and a TypeRef in the referencing one.
+    database const synthetic{ files[0] };
+    auto const architecture = synthetic.find_type("Windows.Win32.Foundation.Metadata", "Architecture");
+    REQUIRE(architecture);
+    REQUIRE(synthetic.enum_underlying_type(architecture) == ElementType::I4);
+    REQUIRE(synthetic.enum_underlying_type(synthetic.find_type("Synthetic.N0", "S0@X86")) == ElementType::End);
+    REQUIRE(!synthetic.find_type("Synthetic.N0", "Missing"));
+    expected = check_values(synthetic);
+
+    // Without a cache, a reference into another assembly cannot be resolved, which is an error rather than a crash.
+    database const referencing{ files[1] };
+    auto const attribute = std::find_if(referencing.CustomAttribute.begin(), referencing.CustomAttribute.end(), [](auto&& attribute)
+    {
+        return attribute.TypeNamespaceAndName().second == "SupportedArchitectureAttribute";
+    });
+    REQUIRE(attribute != referencing.CustomAttribute.end());
+    REQUIRE_THROWS_AS(attribute.Value(), std::invalid_argument);
+
+    cache c(files);
+    REQUIRE(check_values(c.databases().back()) == expected);
+    c.resolve_type_refs(Architecture::All);
+    REQUIRE(check_values(c.databases().back()) == expected);
+}
+
+TEST_CASE("simd_kernels")
+{
+    using winmd::impl::simd_level;
+    std::vector<simd_level> levels{ simd_level::scalar, winmd::impl::supported_simd_level() };
+
+    if (levels.back() == simd_level::avx2)
+    {
+        levels.push_back(simd_level::sse2);
+    }
+
+    std::mt19937 random{ 23 };
+    std::vector<uint8_t> bytes(4096 + 64);
+
+    for (auto&& byte : bytes)
+    {
+        byte = random() % 8 ? static_cast<uint8_t>('A' + random() % 26) : 0;
+    }
+
+    // Every alignment of the start and every length of the tail, for each kernel the processor can run.
+    for (std::size_t first = 0; first < 64; first += 7)
+    {
+        for (std::size_t size : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 15 }, std::size_t{ 63 }, std::size_t{ 64 }, std::size_t{ 65 }, std::size_t{ 4096 } })
+        {
+            std::vector<uint32_t> expected;
+
+            for (std::size_t offset = 0; offset < size; ++offset)
+            {
+                if (!bytes[first + offset])
+                {
+                    expected.push_back(static_cast<uint32_t>(offset));
+                }
+            }
+
+            for (auto level : levels)
+            {
+                std::vector<uint32_t> offsets;
+                winmd::impl::find_zero_bytes(bytes.data() + first, bytes.data() + first + size, offsets, level);
+                REQUIRE(offsets == expected);
+
+                auto const terminator = winmd::impl::find_terminator(bytes.data() + first, bytes.data() + first + size, level);
+                REQUIRE(terminator == (expected.empty() ? nullptr : bytes.data() + first + expected.front()));
+            }
+        }
+    }
+
+    // A lone terminator at every position of a long run, so that each kernel's vector loop runs to it.
+    std::vector<uint8_t> run(200, 'x');
+
+    for (std::size_t position = 0; position <= run.size(); ++position)
+    {
+        if (position < run.size())
+        {
+            run[position] = 0;
+        }
+
+        for (auto level : levels)
+        {
+            auto const terminator = winmd::impl::find_terminator(run.data(), run.data() + run.size(), level);
+            REQUIRE(terminator == (position < run.size() ? run.data() + position : nullptr));
+        }
+
+        if (position < run.size())
+        {
+            run[position] = 'x';
+        }
+    }
+
+    std::string const text(100, 'x');
+
+    for (std::size_t size = 0; size <= 70; ++size)
+    {
+        std::string other = text;
+        REQUIRE(winmd::impl::equal_bytes(text.data(), other.data(), size));
+
+        for (std::size_t position = 0; position < size; ++position)
+        {
+            other[position] = 'y';
+            REQUIRE(!winmd::impl::equal_bytes(text.data(), other.data(), size));
+            other[position] = 'x';
+        }
+    }
+
+    REQUIRE(winmd::impl::starts_with("Windows.Foundation", "Windows."));
+    REQUIRE(winmd::impl::starts_with("Windows", ""));
+    REQUIRE(!winmd::impl::starts_with("Windows", "Windows."));
+    REQUIRE(!winmd::impl::starts_with("Windows.Foundation", "Windows.Foundatiom"));
+}
+
+TEST_CASE("compressed_integers")
+{
+    // Values at the edges of each encoding length, encoded as in ECMA-335 II.23.2.
+    std::vector<uint32_t> const values{ 0, 1, 0x7f, 0x80, 0x2e57, 0x3fff, 0x4000, 0x123456, 0x1fffffff };
+    std::vector<uint8_t> bytes;
+
+    for (auto value : values)
+    {
+        if (value < 0x80)
+        {
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+        else if (value < 0x4000)
+        {
+            bytes.push_back(static_cast<uint8_t>(0x80 | (value >> 8)));
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+        else
+        {
+            bytes.push_back(static_cast<uint8_t>(0xc0 | (value >> 24)));
+            bytes.push_back(static_cast<uint8_t>(value >> 16));
+            bytes.push_back(static_cast<uint8_t>(value >> 8));
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+    }
+
+    // One at a time, including the last few values where fewer than four bytes remain.
+    byte_view cursor{ bytes.data(), bytes.data() + bytes.size() };
+
+    for (auto value : values)
+    {
+        REQUIRE(uncompress_unsigned(cursor) == value);
+    }
+
+    REQUIRE(cursor.size() == 0);
+    REQUIRE_THROWS_AS(uncompress_unsigned(cursor), std::invalid_argument);
+
+    // As a run, decoded both without and (near the end) with per-value bounds checks.
+    std::vector<uint32_t> decoded(values.size());
+    cursor = { bytes.data(), bytes.data() + bytes.size() };
+    uncompress_unsigned(cursor, decoded.data(), static_cast<uint32_t>(decoded.size()));
+    REQUIRE(decoded == values);
+    REQUIRE(cursor.size() == 0);
+
+    cursor = { bytes.data(), bytes.data() + bytes.size() };
+    auto const [first, second, third] = uncompress_unsigned<3>(cursor);
+    REQUIRE((first == values[0] && second == values[1] && third == values[2]));
+
+    // A truncated value and the reserved 111 prefix are rejected.
+    cursor = { bytes.data() + bytes.size() - 3, bytes.data() + bytes.size() };
+    REQUIRE_THROWS_AS(uncompress_unsigned(cursor), std::invalid_argument);
+
+    uint8_t const reserved[]{ 0xe0, 0, 0, 0, 0 };
+    cursor = { std::begin(reserved), std::end(reserved) };
+    REQUIRE_THROWS_AS(uncompress_unsigned(cursor), std::invalid_argument);
+}
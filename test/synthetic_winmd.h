@@ -0,0 +1,916 @@
+#pragma once
+
+#include <cstring>
+#include <winmd_reader.h>
+
+// Writes small, deterministic .winmd files that look like Win32 metadata: a SupportedArchitecture attribute
+// with same-named architecture variants, nested anonymous types, NativeTypeName attributes, const modifiers
+// and cross-file TypeRefs. Used by the tests and benchmarks so they do not depend on %windir% metadata.
+
+namespace winmd::test
+{
+    struct synthetic_options
+    {
+        std::string assembly_name{ "Synthetic" };
+        std::string referenced_assembly; // Types of this (previously generated) assembly are referenced through TypeRefs
+        uint32_t namespaces{ 4 };
+        uint32_t types_per_namespace{ 32 };
+        uint32_t fields_per_type{ 4 };
+        uint32_t methods_per_namespace{ 16 };
+        uint32_t params_per_method{ 3 };
+        uint32_t nested_every{ 4 };       // Every Nth struct gets nested anonymous unions
+        uint32_t nested_per_type{ 1 };    // Number of anonymous unions in each of those structs
+        uint32_t arch_variant_every{ 8 }; // Every Nth struct is emitted once per architecture
+    };
+
+    namespace impl
+    {
+        using namespace winmd::reader;
+
+        inline void write_compressed(std::vector<uint8_t>& out, uint32_t value)
+        {
+            if (value < 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(value));
+            }
+            else if (value < 0x4000)
+            {
+                out.push_back(static_cast<uint8_t>(0x80 | (value >> 8)));
+                out.push_back(static_cast<uint8_t>(value));
+            }
+            else
+            {
+                out.push_back(static_cast<uint8_t>(0xc0 | (value >> 24)));
+                out.push_back(static_cast<uint8_t>(value >> 16));
+                out.push_back(static_cast<uint8_t>(value >> 8));
+                out.push_back(static_cast<uint8_t>(value));
+            }
+        }
+
+        template <typename T>
+        void write_value(std::vector<uint8_t>& out, T const value)
+        {
+            auto const first = reinterpret_cast<uint8_t const*>(&value);
+            out.insert(out.end(), first, first + sizeof(T));
+        }
+
+        inline void write_index(std::vector<uint8_t>& out, uint32_t const value, uint8_t const size)
+        {
+            if (size == 2)
+            {
+                write_value(out, static_cast<uint16_t>(value));
+            }
+            else
+            {
+                write_value(out, value);
+            }
+        }
+
+        template <typename T>
+        uint32_t coded(T const tag, uint32_t const row) noexcept
+        {
+            return ((row + 1) << coded_index_bits_v<T>) | static_cast<uint32_t>(tag);
+        }
+
+        enum table_id : uint32_t
+        {
+            Module = 0x00,
+            TypeRef = 0x01,
+            TypeDef = 0x02,
+            Field = 0x04,
+            MethodDef = 0x06,
+            Param = 0x08,
+            MemberRef = 0x0a,
+            Constant = 0x0b,
+            CustomAttribute = 0x0c,
+            Assembly = 0x20,
+            AssemblyRef = 0x23,
+            NestedClass = 0x29,
+        };
+
+        struct builder
+        {
+            struct type_ref_row { uint32_t scope; uint32_t name; uint32_t ns; };
+            struct type_def_row { uint32_t flags; uint32_t name; uint32_t ns; uint32_t extends; uint32_t fields; uint32_t methods; };
+            struct field_row { uint16_t flags; uint32_t name; uint32_t signature; };
+            struct method_row { uint16_t impl_flags; uint16_t flags; uint32_t name; uint32_t signature; uint32_t params; };
+            struct param_row { uint16_t flags; uint16_t sequence; uint32_t name; };
+            struct member_ref_row { uint32_t parent; uint32_t name; uint32_t signature; };
+            struct constant_row { uint8_t type; uint32_t parent; uint32_t value; };
+            struct attribute_row { uint32_t parent; uint32_t type; uint32_t value; };
+            struct nested_row { uint32_t nested; uint32_t enclosing; };
+            struct assembly_ref_row { uint32_t name; };
+
+            builder()
+            {
+                m_strings.push_back(0);
+                m_blobs.push_back(0);
+            }
+
+            uint32_t string(std::string_view const& value)
+            {
+                auto [pos, inserted] = m_string_map.try_emplace(std::string{ value }, static_cast<uint32_t>(m_strings.size()));
+                if (inserted)
+                {
+                    m_strings.insert(m_strings.end(), value.begin(), value.end());
+                    m_strings.push_back(0);
+                }
+                return pos->second;
+            }
+
+            uint32_t blob(std::vector<uint8_t> const& value)
+            {
+                auto [pos, inserted] = m_blob_map.try_emplace(value, static_cast<uint32_t>(m_blobs.size()));
+                if (inserted)
+                {
+                    write_compressed(m_blobs, static_cast<uint32_t>(value.size()));
+                    m_blobs.insert(m_blobs.end(), value.begin(), value.end());
+                }
+                return pos->second;
+            }
+
+            std::string module_name;
+            std::string assembly_name;
+            std::vector<type_ref_row> type_refs;
+            std::vector<type_def_row> type_defs;
+            std::vector<field_row> fields;
+            std::vector<method_row> methods;
+            std::vector<param_row> params;
+            std::vector<member_ref_row> member_refs;
+            std::vector<constant_row> constants;
+            std::vector<attribute_row> attributes;
+            std::vector<nested_row> nested;
+            std::vector<assembly_ref_row> assembly_refs;
+
+            std::vector<uint8_t> save()
+            {
+                std::sort(constants.begin(), constants.end(), [](auto&& lhs, auto&& rhs) { return lhs.parent < rhs.parent; });
+                std::stable_sort(attributes.begin(), attributes.end(), [](auto&& lhs, auto&& rhs) { return lhs.parent < rhs.parent; });
+                std::sort(nested.begin(), nested.end(), [](auto&& lhs, auto&& rhs) { return lhs.nested < rhs.nested; });
+
+                std::map<uint32_t, uint32_t> rows;
+                rows[Module] = 1;
+                rows[TypeRef] = static_cast<uint32_t>(type_refs.size());
+                rows[TypeDef] = static_cast<uint32_t>(type_defs.size());
+                rows[Field] = static_cast<uint32_t>(fields.size());
+                rows[MethodDef] = static_cast<uint32_t>(methods.size());
+                rows[Param] = static_cast<uint32_t>(params.size());
+                rows[MemberRef] = static_cast<uint32_t>(member_refs.size());
+                rows[Constant] = static_cast<uint32_t>(constants.size());
+                rows[CustomAttribute] = static_cast<uint32_t>(attributes.size());
+                rows[Assembly] = 1;
+                rows[AssemblyRef] = static_cast<uint32_t>(assembly_refs.size());
+                rows[NestedClass] = static_cast<uint32_t>(nested.size());
+
+                auto const module_name_index = string(module_name);
+                auto const assembly_name_index = string(assembly_name);
+
+                uint8_t const string_size = m_strings.size() < 0x10000 ? 2 : 4;
+                uint8_t const blob_size = m_blobs.size() < 0x10000 ? 2 : 4;
+                auto index_size = [&](uint32_t table) -> uint8_t { return rows[table] < 0x10000 ? 2 : 4; };
+                auto coded_size = [&](uint32_t bits, std::initializer_list<uint32_t> tables) -> uint8_t
+                {
+                    for (auto table : tables)
+                    {
+                        if (rows[table] >= (1u << (16 - bits)))
+                        {
+                            return 4;
+                        }
+                    }
+                    return 2;
+                };
+
+                auto const type_def_or_ref = coded_size(2, { TypeDef, TypeRef });
+                auto const has_constant = coded_size(2, { Field, Param });
+                auto const has_custom_attribute = coded_size(5, { MethodDef, Field, TypeRef, TypeDef, Param, MemberRef, Module, Assembly, AssemblyRef });
+                auto const member_ref_parent = coded_size(3, { TypeDef, TypeRef, MethodDef });
+                auto const custom_attribute_type = coded_size(3, { MethodDef, MemberRef });
+                auto const resolution_scope = coded_size(2, { Module, AssemblyRef, TypeRef });
+
+                std::vector<uint8_t> tables;
+                write_value<uint32_t>(tables, 0);
+                write_value<uint8_t>(tables, 2);
+                write_value<uint8_t>(tables, 0);
+                write_value<uint8_t>(tables, static_cast<uint8_t>((string_size == 4 ? 1 : 0) | (blob_size == 4 ? 4 : 0)));
+                write_value<uint8_t>(tables, 1);
+                uint64_t valid{};
+                for (auto&& [table, count] : rows)
+                {
+                    if (count)
+                    {
+                        valid |= 1ull << table;
+                    }
+                }
+                write_value<uint64_t>(tables, valid);
+                write_value<uint64_t>(tables, (1ull << Constant) | (1ull << CustomAttribute) | (1ull << NestedClass));
+                for (auto&& [table, count] : rows)
+                {
+                    if (count)
+                    {
+                        write_value<uint32_t>(tables, count);
+                    }
+                }
+
+                // Module
+                write_value<uint16_t>(tables, 0);
+                write_index(tables, module_name_index, string_size);
+                write_index(tables, 1, 2);
+                write_index(tables, 0, 2);
+                write_index(tables, 0, 2);
+
+                for (auto&& row : type_refs)
+                {
+                    write_index(tables, row.scope, resolution_scope);
+                    write_index(tables, row.name, string_size);
+                    write_index(tables, row.ns, string_size);
+                }
+
+                for (auto&& row : type_defs)
+                {
+                    write_value(tables, row.flags);
+                    write_index(tables, row.name, string_size);
+                    write_index(tables, row.ns, string_size);
+                    write_index(tables, row.extends, type_def_or_ref);
+                    write_index(tables, row.fields, index_size(Field));
+                    write_index(tables, row.methods, index_size(MethodDef));
+                }
+
+                for (auto&& row : fields)
+                {
+                    write_value(tables, row.flags);
+                    write_index(tables, row.name, string_size);
+                    write_index(tables, row.signature, blob_size);
+                }
+
+                for (auto&& row : methods)
+                {
+                    write_value<uint32_t>(tables, 0);
+                    write_value(tables, row.impl_flags);
+                    write_value(tables, row.flags);
+                    write_index(tables, row.name, string_size);
+                    write_index(tables, row.signature, blob_size);
+                    write_index(tables, row.params, index_size(Param));
+                }
+
+                for (auto&& row : params)
+                {
+                    write_value(tables, row.flags);
+                    write_value(tables, row.sequence);
+                    write_index(tables, row.name, string_size);
+                }
+
+                for (auto&& row : member_refs)
+                {
+                    write_index(tables, row.parent, member_ref_parent);
+                    write_index(tables, row.name, string_size);
+                    write_index(tables, row.signature, blob_size);
+                }
+
+                for (auto&& row : constants)
+                {
+                    write_value<uint16_t>(tables, row.type);
+                    write_index(tables, row.parent, has_constant);
+                    write_index(tables, row.value, blob_size);
+                }
+
+                for (auto&& row : attributes)
+                {
+                    write_index(tables, row.parent, has_custom_attribute);
+                    write_index(tables, row.type, custom_attribute_type);
+                    write_index(tables, row.value, blob_size);
+                }
+
+                // Assembly
+                write_value<uint32_t>(tables, 0x8004);
+                write_value<uint64_t>(tables, 0x0000000000000001ull);
+                write_value<uint32_t>(tables, 0x200);
+                write_index(tables, 0, blob_size);
+                write_index(tables, assembly_name_index, string_size);
+                write_index(tables, 0, string_size);
+
+                for (auto&& row : assembly_refs)
+                {
+                    write_value<uint64_t>(tables, 0x0000000000000001ull);
+                    write_value<uint32_t>(tables, 0x200);
+                    write_index(tables, 0, blob_size);
+                    write_index(tables, row.name, string_size);
+                    write_index(tables, 0, string_size);
+                    write_index(tables, 0, blob_size);
+                }
+
+                for (auto&& row : nested)
+                {
+                    write_index(tables, row.nested, index_size(TypeDef));
+                    write_index(tables, row.enclosing, index_size(TypeDef));
+                }
+
+                return write_image(tables);
+            }
+
+        private:
+
+            std::vector<uint8_t> write_image(std::vector<uint8_t> const& tables)
+            {
+                std::vector<uint8_t> guids(16, 0x5a);
+
+                auto pad = [](std::vector<uint8_t>& out, size_t alignment)
+                {
+                    while (out.size() % alignment)
+                    {
+                        out.push_back(0);
+                    }
+                };
+
+                std::vector<std::pair<std::string_view, std::vector<uint8_t> const*>> streams{ { "#~", &tables }, { "#Strings", &m_strings }, { "#Blob", &m_blobs }, { "#GUID", &guids } };
+
+                std::vector<uint8_t> metadata;
+                write_value<uint32_t>(metadata, 0x424a5342);
+                write_value<uint16_t>(metadata, 1);
+                write_value<uint16_t>(metadata, 1);
+                write_value<uint32_t>(metadata, 0);
+                std::string_view const version{ "v4.0.30319\0\0", 12 };
+                write_value<uint32_t>(metadata, static_cast<uint32_t>(version.size()));
+                metadata.insert(metadata.end(), version.begin(), version.end());
+                write_value<uint16_t>(metadata, 0);
+                write_value<uint16_t>(metadata, static_cast<uint16_t>(streams.size()));
+
+                uint32_t header_size = static_cast<uint32_t>(metadata.size());
+                for (auto&& [name, data] : streams)
+                {
+                    header_size += 8 + static_cast<uint32_t>((name.size() + 4) & ~3u);
+                }
+
+                uint32_t offset = header_size;
+                for (auto&& [name, data] : streams)
+                {
+                    uint32_t const size = static_cast<uint32_t>((data->size() + 3) & ~size_t{ 3 });
+                    write_value<uint32_t>(metadata, offset);
+                    write_value<uint32_t>(metadata, size);
+                    metadata.insert(metadata.end(), name.begin(), name.end());
+                    metadata.push_back(0);
+                    pad(metadata, 4);
+                    offset += size;
+                }
+
+                for (auto&& [name, data] : streams)
+                {
+                    metadata.insert(metadata.end(), data->begin(), data->end());
+                    pad(metadata, 4);
+                }
+
+                uint32_t const file_alignment = 0x200;
+                uint32_t const section_rva = 0x2000;
+                uint32_t const metadata_rva = section_rva + sizeof(winmd::impl::image_cor20_header);
+
+                std::vector<uint8_t> image(file_alignment, 0);
+                auto& dos = reinterpret_cast<winmd::impl::image_dos_header&>(image[0]);
+                dos.e_signature = 0x5A4D;
+                dos.e_lfanew = 0x80;
+
+                auto& nt = reinterpret_cast<winmd::impl::image_nt_headers32&>(image[0x80]);
+                nt.Signature = 0x00004550;
+                nt.FileHeader.Machine = 0x14c;
+                nt.FileHeader.NumberOfSections = 1;
+                nt.FileHeader.SizeOfOptionalHeader = sizeof(winmd::impl::image_optional_header32);
+                nt.FileHeader.Characteristics = 0x2102;
+                nt.OptionalHeader.Magic = 0x10B;
+                nt.OptionalHeader.SectionAlignment = 0x2000;
+                nt.OptionalHeader.FileAlignment = file_alignment;
+                nt.OptionalHeader.SizeOfHeaders = file_alignment;
+                nt.OptionalHeader.NumberOfRvaAndSizes = 16;
+                nt.OptionalHeader.DataDirectory[14] = { section_rva, sizeof(winmd::impl::image_cor20_header) };
+
+                uint32_t const section_size = static_cast<uint32_t>(sizeof(winmd::impl::image_cor20_header) + metadata.size());
+                uint32_t const raw_size = (section_size + file_alignment - 1) & ~(file_alignment - 1);
+                nt.OptionalHeader.SizeOfImage = section_rva + ((section_size + 0x1fff) & ~0x1fffu);
+
+                auto& section = reinterpret_cast<winmd::impl::image_section_header&>(image[0x80 + sizeof(winmd::impl::image_nt_headers32)]);
+                std::memcpy(section.Name, ".text", 5);
+                section.Misc.VirtualSize = section_size;
+                section.VirtualAddress = section_rva;
+                section.SizeOfRawData = raw_size;
+                section.PointerToRawData = file_alignment;
+                section.Characteristics = 0x60000020;
+
+                winmd::impl::image_cor20_header cli{};
+                cli.cb = sizeof(winmd::impl::image_cor20_header);
+                cli.MajorRuntimeVersion = 2;
+                cli.MinorRuntimeVersion = 5;
+                cli.MetaData = { metadata_rva, static_cast<uint32_t>(metadata.size()) };
+                cli.Flags = 1;
+                write_value(image, cli);
+                image.insert(image.end(), metadata.begin(), metadata.end());
+                image.resize(file_alignment + raw_size, 0);
+                return image;
+            }
+
+            std::vector<uint8_t> m_strings;
+            std::vector<uint8_t> m_blobs;
+            std::map<std::string, uint32_t> m_string_map;
+            std::map<std::vector<uint8_t>, uint32_t> m_blob_map;
+        };
+
+        struct generator
+        {
+            explicit generator(synthetic_options const& options) : m_options(options)
+            {
+                m_builder.module_name = options.assembly_name + ".winmd";
+                m_builder.assembly_name = options.assembly_name;
+            }
+
+            std::vector<uint8_t> run()
+            {
+                auto& b = m_builder;
+
+                m_system_object = add_type_ref(system_scope(), "System", "Object");
+                m_system_value_type = add_type_ref(system_scope(), "System", "ValueType");
+                m_system_enum = add_type_ref(system_scope(), "System", "Enum");
+                m_system_delegate = add_type_ref(system_scope(), "System", "MulticastDelegate");
+                m_system_attribute = add_type_ref(system_scope(), "System", "Attribute");
+                m_is_const = add_type_ref(system_scope(), "System.Runtime.CompilerServices", "IsConst");
+
+                add_type_def(0, "<Module>", "", 0);
+
+                if (m_options.referenced_assembly.empty())
+                {
+                    define_metadata_types();
+                }
+                else
+                {
+                    reference_metadata_types();
+                }
+
+                for (uint32_t ns = 0; ns < m_options.namespaces; ++ns)
+                {
+                    define_namespace(ns);
+                }
+
+                return b.save();
+            }
+
+        private:
+
+            static constexpr std::string_view metadata_namespace{ "Windows.Win32.Foundation.Metadata" };
+            static constexpr std::array<int32_t, 2> variant_arches{ 1 /* X86 */, 2 | 4 /* X64 | Arm64 */ };
+
+            uint32_t system_scope()
+            {
+                if (!m_mscorlib)
+                {
+                    m_builder.assembly_refs.push_back({ m_builder.string("mscorlib") });
+                    m_mscorlib = coded(reader::ResolutionScope::AssemblyRef, static_cast<uint32_t>(m_builder.assembly_refs.size() - 1));
+                }
+                return m_mscorlib;
+            }
+
+            uint32_t referenced_scope()
+            {
+                if (!m_referenced)
+                {
+                    m_builder.assembly_refs.push_back({ m_builder.string(m_options.referenced_assembly) });
+                    m_referenced = coded(reader::ResolutionScope::AssemblyRef, static_cast<uint32_t>(m_builder.assembly_refs.size() - 1));
+                }
+                return m_referenced;
+            }
+
+            uint32_t add_type_ref(uint32_t scope, std::string_view const& ns, std::string_view const& name)
+            {
+                m_builder.type_refs.push_back({ scope, m_builder.string(name), m_builder.string(ns) });
+                return coded(TypeDefOrRef::TypeRef, static_cast<uint32_t>(m_builder.type_refs.size() - 1));
+            }
+
+            uint32_t add_type_def(uint32_t flags, std::string_view const& name, std::string_view const& ns, uint32_t extends)
+            {
+                auto& b = m_builder;
+                b.type_defs.push_back({ flags, b.string(name), b.string(ns), extends, static_cast<uint32_t>(b.fields.size() + 1), static_cast<uint32_t>(b.methods.size() + 1) });
+                return static_cast<uint32_t>(b.type_defs.size() - 1);
+            }
+
+            uint32_t add_field(uint16_t flags, std::string_view const& name, std::vector<uint8_t> const& type)
+            {
+                std::vector<uint8_t> signature{ 0x06 };
+                signature.insert(signature.end(), type.begin(), type.end());
+                m_builder.fields.push_back({ flags, m_builder.string(name), m_builder.blob(signature) });
+                return static_cast<uint32_t>(m_builder.fields.size() - 1);
+            }
+
+            uint32_t add_method(uint16_t flags, std::string_view const& name, std::vector<uint8_t> const& signature)
+            {
+                m_builder.methods.push_back({ 0, flags, m_builder.string(name), m_builder.blob(signature), static_cast<uint32_t>(m_builder.params.size() + 1) });
+                return static_cast<uint32_t>(m_builder.methods.size() - 1);
+            }
+
+            void add_attribute(uint32_t parent, uint32_t ctor, std::vector<uint8_t> const& args)
+            {
+                std::vector<uint8_t> value{ 0x01, 0x00 };
+                value.insert(value.end(), args.begin(), args.end());
+                value.push_back(0);
+                value.push_back(0);
+                m_builder.attributes.push_back({ parent, ctor, m_builder.blob(value) });
+            }
+
+            void add_arch_attribute(uint32_t parent, int32_t arches)
+            {
+                std::vector<uint8_t> args;
+                write_value(args, arches);
+                add_attribute(parent, m_arch_ctor, args);
+            }
+
+            void add_native_type_name(uint32_t parent, std::string_view const& name)
+            {
+                std::vector<uint8_t> args;
+                write_compressed(args, static_cast<uint32_t>(name.size()));
+                args.insert(args.end(), name.begin(), name.end());
+                add_attribute(parent, m_native_type_name_ctor, args);
+            }
+
+            static std::vector<uint8_t> value_type(uint32_t type)
+            {
+                std::vector<uint8_t> result{ static_cast<uint8_t>(ElementType::ValueType) };
+                write_compressed(result, type);
+                return result;
+            }
+
+            static std::vector<uint8_t> ctor_signature(std::vector<uint8_t> const& param)
+            {
+                std::vector<uint8_t> result{ 0x20, 0x01, static_cast<uint8_t>(ElementType::Void) };
+                result.insert(result.end(), param.begin(), param.end());
+                return result;
+            }
+
+            void define_metadata_types()
+            {
+                auto& b = m_builder;
+                uint16_t const ctor_flags = 0x1886;
+
+                auto const arch = add_type_def(0x101, "Architecture", metadata_namespace, m_system_enum);
+                m_architecture = coded(TypeDefOrRef::TypeDef, arch);
+                add_field(0x0606, "value__", { static_cast<uint8_t>(ElementType::I4) });
+                std::array<std::pair<std::string_view, int32_t>, 5> const values{ { { "None", 0 }, { "X86", 1 }, { "X64", 2 }, { "Arm64", 4 }, { "All", 7 } } };
+                for (auto&& [name, value] : values)
+                {
+                    auto const field = add_field(0x8056, name, value_type(m_architecture));
+                    std::vector<uint8_t> constant;
+                    write_value(constant, value);
+                    b.constants.push_back({ static_cast<uint8_t>(ConstantType::Int32), coded(HasConstant::Field, field), b.blob(constant) });
+                }
+
+                add_type_def(0x100101, "SupportedArchitectureAttribute", metadata_namespace, m_system_attribute);
+                m_arch_ctor = coded(CustomAttributeType::MethodDef, add_method(ctor_flags, ".ctor", ctor_signature(value_type(m_architecture))));
+
+                add_type_def(0x100101, "NativeTypeNameAttribute", metadata_namespace, m_system_attribute);
+                m_native_type_name_ctor = coded(CustomAttributeType::MethodDef, add_method(ctor_flags, ".ctor", ctor_signature({ static_cast<uint8_t>(ElementType::String) })));
+            }
+
+            void reference_metadata_types()
+            {
+                auto& b = m_builder;
+                auto const scope = referenced_scope();
+                m_architecture = add_type_ref(scope, metadata_namespace, "Architecture");
+
+                auto member_ref = [&](std::string_view const& name, std::vector<uint8_t> const& param)
+                {
+                    auto const parent = add_type_ref(scope, metadata_namespace, name);
+                    b.member_refs.push_back({ coded(MemberRefParent::TypeRef, (parent >> 2) - 1), b.string(".ctor"), b.blob(ctor_signature(param)) });
+                    return coded(CustomAttributeType::MemberRef, static_cast<uint32_t>(b.member_refs.size() - 1));
+                };
+
+                m_arch_ctor = member_ref("SupportedArchitectureAttribute", value_type(m_architecture));
+                m_native_type_name_ctor = member_ref("NativeTypeNameAttribute", { static_cast<uint8_t>(ElementType::String) });
+            }
+
+            static std::string nested_name(uint32_t n)
+            {
+                return n == 0 ? "_Anonymous_e__Union" : "_Anonymous" + std::to_string(n) + "_e__Union";
+            }
+
+            std::string namespace_name(std::string_view const& assembly, uint32_t ns) const
+            {
+                return std::string{ assembly } + ".N" + std::to_string(ns);
+            }
+
+            void define_namespace(uint32_t ns_index)
+            {
+                auto& b = m_builder;
+                auto const ns = namespace_name(m_options.assembly_name, ns_index);
+                std::vector<uint32_t> structs;
+                std::vector<uint32_t> enums;
+                std::vector<uint32_t> external;
+
+                if (!m_options.referenced_assembly.empty())
+                {
+                    auto const scope = referenced_scope();
+                    auto const other = namespace_name(m_options.referenced_assembly, ns_index % std::max(1u, m_options.namespaces));
+                    for (uint32_t i = 0; i < m_options.types_per_namespace; i += 4)
+                    {
+                        auto const name = "S" + std::to_string(i);
+                        auto const type = add_type_ref(scope, other, name);
+                        external.push_back(type);
+
+                        if (m_options.nested_every && i % m_options.nested_every == 0)
+                        {
+                            for (uint32_t n = 0; n < m_options.nested_per_type; ++n)
+                            {
+                                m_builder.type_refs.push_back({ coded(reader::ResolutionScope::TypeRef, (type >> 2) - 1), b.string(nested_name(n)), b.string("") });
+                                external.push_back(coded(TypeDefOrRef::TypeRef, static_cast<uint32_t>(b.type_refs.size() - 1)));
+                            }
+                        }
+                    }
+                }
+
+                for (uint32_t i = 0; i < m_options.types_per_namespace; ++i)
+                {
+                    auto const name = std::to_string(i);
+                    switch (i % 4)
+                    {
+                    case 0:
+                    case 1:
+                    {
+                        bool const variants = m_options.arch_variant_every && i % m_options.arch_variant_every == 0;
+                        for (size_t v = 0; v < (variants ? variant_arches.size() : 1); ++v)
+                        {
+                            auto const type = define_struct(ns, "S" + name, i, variants ? variant_arches[v] : 0, structs, enums, external);
+                            structs.push_back(coded(TypeDefOrRef::TypeDef, type));
+                        }
+                        break;
+                    }
+                    case 2:
+                    {
+                        auto const type = define_enum(ns, "E" + name, i);
+                        enums.push_back(coded(TypeDefOrRef::TypeDef, type));
+                        break;
+                    }
+                    default:
+                        if (i % 8 == 3)
+                        {
+                            define_interface(ns, "I" + name, structs);
+                        }
+                        else
+                        {
+                            define_delegate(ns, "D" + name, structs);
+                        }
+                        break;
+                    }
+                }
+
+                auto const apis = add_type_def(0x100181, "Apis", ns, m_system_object);
+                (void)apis;
+                for (uint32_t m = 0; m < m_options.methods_per_namespace; ++m)
+                {
+                    define_method(0x2096, "Func" + std::to_string(m), m, structs, enums, external);
+                }
+            }
+
+            std::vector<uint8_t> param_type(uint32_t seed, std::vector<uint32_t> const& structs, std::vector<uint32_t> const& enums, std::vector<uint32_t> const& external)
+            {
+                std::vector<uint8_t> result;
+                switch (seed % 8)
+                {
+                case 0:
+                    result.push_back(static_cast<uint8_t>(ElementType::I4));
+                    break;
+                case 1:
+                    if (!structs.empty())
+                    {
+                        result.push_back(static_cast<uint8_t>(ElementType::Ptr));
+                        auto const type = value_type(structs[seed % structs.size()]);
+                        result.insert(result.end(), type.begin(), type.end());
+                        break;
+                    }
+                    result.push_back(static_cast<uint8_t>(ElementType::U8));
+                    break;
+                case 2:
+                    result.push_back(static_cast<uint8_t>(ElementType::CModOpt));
+                    write_compressed(result, m_is_const);
+                    result.push_back(static_cast<uint8_t>(ElementType::Ptr));
+                    result.push_back(static_cast<uint8_t>(ElementType::U2));
+                    break;
+                case 3:
+                    if (!enums.empty())
+                    {
+                        result = value_type(enums[seed % enums.size()]);
+                        break;
+                    }
+                    result.push_back(static_cast<uint8_t>(ElementType::U4));
+                    break;
+                case 4:
+                    result.push_back(static_cast<uint8_t>(ElementType::SZArray));
+                    result.push_back(static_cast<uint8_t>(ElementType::U1));
+                    break;
+                case 5:
+                    if (!external.empty())
+                    {
+                        result.push_back(static_cast<uint8_t>(ElementType::Ptr));
+                        auto const type = value_type(external[seed % external.size()]);
+                        result.insert(result.end(), type.begin(), type.end());
+                        break;
+                    }
+                    result.push_back(static_cast<uint8_t>(ElementType::I));
+                    break;
+                case 6:
+                    result.push_back(static_cast<uint8_t>(ElementType::Ptr));
+                    result.push_back(static_cast<uint8_t>(ElementType::Ptr));
+                    result.push_back(static_cast<uint8_t>(ElementType::Void));
+                    break;
+                default:
+                    if (!structs.empty())
+                    {
+                        result = value_type(structs[(seed / 8) % structs.size()]);
+                        break;
+                    }
+                    result.push_back(static_cast<uint8_t>(ElementType::R8));
+                    break;
+                }
+                return result;
+            }
+
+            uint32_t define_struct(std::string const& ns, std::string const& name, uint32_t seed, int32_t arches, std::vector<uint32_t> const& structs, std::vector<uint32_t> const& enums, std::vector<uint32_t> const& external)
+            {
+                auto& b = m_builder;
+                bool const has_nested = m_options.nested_every && seed % m_options.nested_every == 0;
+                auto const type = add_type_def(0x100109, name, ns, m_system_value_type);
+                if (arches)
+                {
+                    add_arch_attribute(coded(HasCustomAttribute::TypeDef, type), arches);
+                }
+
+                for (uint32_t f = 0; f < m_options.fields_per_type; ++f)
+                {
+                    auto const field = add_field(0x0006, "f" + std::to_string(f), param_type(seed + f, structs, enums, external));
+                    if (f == 0)
+                    {
+                        add_native_type_name(coded(HasCustomAttribute::Field, field), "DWORD");
+                    }
+                }
+
+                if (has_nested)
+                {
+                    // The enclosing type's fields must all precede the first nested type's fields.
+                    auto const nested = static_cast<uint32_t>(b.type_defs.size());
+
+                    for (uint32_t n = 0; n < m_options.nested_per_type; ++n)
+                    {
+                        add_field(0x0006, "Anonymous" + std::to_string(n), value_type(coded(TypeDefOrRef::TypeDef, nested + n)));
+                    }
+
+                    for (uint32_t n = 0; n < m_options.nested_per_type; ++n)
+                    {
+                        add_type_def(0x10010a, nested_name(n), "", m_system_value_type);
+                        add_field(0x0006, "Value", { static_cast<uint8_t>(arches == 1 ? ElementType::U4 : ElementType::U8) });
+                        add_field(0x0006, "Bytes", { static_cast<uint8_t>(ElementType::U1) });
+                        b.nested.push_back({ nested + n + 1, type + 1 });
+                    }
+                }
+
+                return type;
+            }
+
+            uint32_t define_enum(std::string const& ns, std::string const& name, uint32_t seed)
+            {
+                auto& b = m_builder;
+                auto const type = add_type_def(0x101, name, ns, m_system_enum);
+                auto const self = coded(TypeDefOrRef::TypeDef, type);
+                add_field(0x0606, "value__", { static_cast<uint8_t>(ElementType::U4) });
+                for (uint32_t f = 0; f < m_options.fields_per_type; ++f)
+                {
+                    auto const field = add_field(0x8056, name + "_" + std::to_string(f), value_type(self));
+                    std::vector<uint8_t> constant;
+                    write_value<uint32_t>(constant, seed + f);
+                    b.constants.push_back({ static_cast<uint8_t>(ConstantType::UInt32), coded(HasConstant::Field, field), b.blob(constant) });
+                }
+                return type;
+            }
+
+            void define_interface(std::string const& ns, std::string const& name, std::vector<uint32_t> const& structs)
+            {
+                add_type_def(0xa1, name, ns, 0);
+                for (uint32_t m = 0; m < 3; ++m)
+                {
+                    define_method(0x05c6, "Method" + std::to_string(m), m + static_cast<uint32_t>(name.size()), structs, {}, {}, 0x21);
+                }
+            }
+
+            void define_delegate(std::string const& ns, std::string const& name, std::vector<uint32_t> const& structs)
+            {
+                add_type_def(0x101, name, ns, m_system_delegate);
+                define_method(0x01c6, "Invoke", static_cast<uint32_t>(name.size()), structs, {}, {}, 0x20);
+            }
+
+            void define_method(uint16_t flags, std::string const& name, uint32_t seed, std::vector<uint32_t> const& structs, std::vector<uint32_t> const& enums, std::vector<uint32_t> const& external, uint8_t convention = 0)
+            {
+                auto& b = m_builder;
+                uint32_t const count = m_options.params_per_method;
+                std::vector<uint8_t> signature{ convention };
+                write_compressed(signature, count);
+                if (seed % 3 == 0)
+                {
+                    signature.push_back(static_cast<uint8_t>(ElementType::Void));
+                }
+                else
+                {
+                    auto const ret = param_type(seed * 7 + 1, structs, enums, external);
+                    signature.insert(signature.end(), ret.begin(), ret.end());
+                }
+                for (uint32_t p = 0; p < count; ++p)
+                {
+                    auto const type = param_type(seed + p * 3, structs, enums, external);
+                    signature.insert(signature.end(), type.begin(), type.end());
+                }
+
+                add_method(flags, name, signature);
+                for (uint32_t p = 0; p < count; ++p)
+                {
+                    b.params.push_back({ 0, static_cast<uint16_t>(p + 1), b.string("p" + std::to_string(p)) });
+                    if (p == 0)
+                    {
+                        add_native_type_name(coded(HasCustomAttribute::Param, static_cast<uint32_t>(b.params.size() - 1)), "LPCWSTR");
+                    }
+                }
+            }
+
+            synthetic_options m_options;
+            builder m_builder;
+            uint32_t m_mscorlib{};
+            uint32_t m_referenced{};
+            uint32_t m_system_object{};
+            uint32_t m_system_value_type{};
+            uint32_t m_system_enum{};
+            uint32_t m_system_delegate{};
+            uint32_t m_system_attribute{};
+            uint32_t m_is_const{};
+            uint32_t m_architecture{};
+            uint32_t m_arch_ctor{};
+            uint32_t m_native_type_name_ctor{};
+        };
+    }
+
+    inline std::vector<uint8_t> make_synthetic_winmd(synthetic_options const& options = {})
+    {
+        return impl::generator{ options }.run();
+    }
+
+    // Applies a command line option such as "--types 64" to options. Returns false if the name is not recognized.
+    inline bool set_synthetic_option(synthetic_options& options, std::string_view const& name, std::string_view const& value)
+    {
+        if (name == "--assembly")
+        {
+            options.assembly_name = value;
+            return true;
+        }
+
+        if (name == "--reference")
+        {
+            options.referenced_assembly = value;
+            return true;
+        }
+
+        std::array<std::pair<std::string_view, uint32_t synthetic_options::*>, 8> const numbers
+        { {
+            { "--namespaces", &synthetic_options::namespaces },
+            { "--types", &synthetic_options::types_per_namespace },
+            { "--fields", &synthetic_options::fields_per_type },
+            { "--methods", &synthetic_options::methods_per_namespace },
+            { "--params", &synthetic_options::params_per_method },
+            { "--nested-every", &synthetic_options::nested_every },
+            { "--nested-per-type", &synthetic_options::nested_per_type },
+            { "--arch-every", &synthetic_options::arch_variant_every },
+        } };
+
+        for (auto&&[option, member] : numbers)
+        {
+            if (option != name)
+            {
+                continue;
+            }
+
+            uint32_t result{};
+
+            for (auto c : value)
+            {
+                if (c < '0' || c > '9')
+                {
+                    winmd::impl::throw_invalid("Option '", name, "' expects a number but was given '", value, "'");
+                }
+
+                result = result * 10 + static_cast<uint32_t>(c - '0');
+            }
+
+            options.*member = result;
+            return true;
+        }
+
+        return false;
+    }
+
+    inline std::string write_synthetic_winmd(std::filesystem::path const& path, synthetic_options const& options = {})
+    {
+        auto const image = make_synthetic_winmd(options);
+        std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+        stream.write(reinterpret_cast<char const*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!stream)
+        {
+            winmd::impl::throw_invalid("Could not write '", path.string(), "'");
+        }
+        return path.string();
+    }
+}